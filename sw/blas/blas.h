@@ -21,4 +21,7 @@ static inline double multiply_opt(double multiplicand, double multiplier) {
 #include "dot/src/dot.h"
 #include "gemm/src/gemm.h"
 #include "gemv/src/gemv.h"
+#include "potrf/src/potrf.h"
+#include "sparse/src/sparse.h"
 #include "syrk/src/syrk.h"
+#include "trsm/src/trsm.h"
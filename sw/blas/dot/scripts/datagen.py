@@ -15,8 +15,13 @@ class DotDataGen(du.DataGen):
     # the occurrence of these splits the data should be aligned to 4KB
     BURST_ALIGNMENT = 4096
 
-    def golden_model(self, x, y):
-        return np.dot(x, y)
+    def golden_model(self, x, y, x_fp32, y_fp32, x_fp16, y_fp16):
+        # The reduced-precision dot products are accumulated in FP32 on the
+        # device, so a reference computed in FP64 is only approximate
+        def dot(a, b):
+            return np.dot(a.astype(np.float64), b.astype(np.float64))
+        return np.array([np.dot(x, y), np.linalg.norm(x), np.sum(np.abs(x)),
+                         np.argmax(np.abs(x)), dot(x_fp32, y_fp32), dot(x_fp16, y_fp16)])
 
     def emit_header(self, **kwargs):
         header = [super().emit_header()]
@@ -24,19 +29,21 @@ class DotDataGen(du.DataGen):
         n = kwargs['n']
         x = du.generate_random_array(n)
         y = du.generate_random_array(n)
-        g = self.golden_model(x, y)
-
-        assert (n % (8 * 4)) == 0, "n must be an integer multiple of the number of cores times " \
-                                   "the unrolling factor"
+        x_fp32, y_fp32 = x.astype(np.float32), y.astype(np.float32)
+        x_fp16, y_fp16 = x.astype(np.float16), y.astype(np.float16)
+        g = self.golden_model(x, y, x_fp32, y_fp32, x_fp16, y_fp16)
 
         header += [du.format_scalar_definition('const uint32_t', 'n', n)]
-        header += [du.format_array_definition('double', 'x', x, alignment=self.BURST_ALIGNMENT,
-                                              section=kwargs['section'])]
-        header += [du.format_array_definition('double', 'y', y, alignment=self.BURST_ALIGNMENT,
-                                              section=kwargs['section'])]
-        header += [du.format_scalar_declaration('double', 'result', alignment=self.BURST_ALIGNMENT,
-                                                section=kwargs['section'])]
-        result_def = du.format_scalar_definition('double', 'g', g)
+        for uid, arr, ctype in [('x', x, 'double'), ('y', y, 'double'),
+                                ('x_fp32', x_fp32, 'float'), ('y_fp32', y_fp32, 'float'),
+                                ('x_fp16', x_fp16, '__fp16'), ('y_fp16', y_fp16, '__fp16')]:
+            header += [du.format_array_definition(ctype, uid, arr,
+                                                  alignment=self.BURST_ALIGNMENT,
+                                                  section=kwargs['section'])]
+        header += [du.format_array_declaration('double', 'result', g.shape,
+                                               alignment=self.BURST_ALIGNMENT,
+                                               section=kwargs['section'])]
+        result_def = du.format_array_definition('double', 'g', g)
         header += [du.format_ifdef_wrapper('BIST', result_def)]
         header = '\n\n'.join(header)
 
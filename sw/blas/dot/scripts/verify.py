@@ -17,12 +17,15 @@ class DotVerifier(Verifier):
         return self.get_output_from_symbol('result', 'double')
 
     def get_expected_results(self):
-        x = self.get_input_from_symbol('x', 'double')
-        y = self.get_input_from_symbol('y', 'double')
-        return DotDataGen().golden_model(x, y)
-
-    def check_results(self, *args):
-        return super().check_results(*args, rtol=1e-10)
+        inputs = [('x', 'double'), ('y', 'double'), ('x_fp32', 'float'), ('y_fp32', 'float'),
+                  ('x_fp16', '__fp16'), ('y_fp16', '__fp16')]
+        inputs = [self.get_input_from_symbol(uid, ctype) for uid, ctype in inputs]
+        return DotDataGen().golden_model(*inputs)
+
+    def check_results(self, actual, expected):
+        # FP64 results, then results accumulated in FP32
+        return super().check_results(actual[:4], expected[:4], rtol=1e-10) | \
+            super().check_results(actual[4:], expected[4:], rtol=1e-2)
 
 
 if __name__ == "__main__":
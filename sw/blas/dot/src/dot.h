@@ -86,60 +86,350 @@ inline void dot_seq_4_acc(uint32_t n, double *x, double *y, double *output) {
     output[0] = res_ssr_0;
 }
 
-static inline void dot(uint32_t n, double *x, double *y, double *result) {
-    double *local_x, *local_y, *partial_sums;
-
-    uint32_t start_cycle, end_cycle;
+// Packed-SIMD dot product of 4 * n_groups 64-bit words, in FP32 or FP16.
+// FP16 products are accumulated in FP32 by the expanding dot product.
+static inline float dot_simd_4_acc(precision_t prec, uint32_t n_groups,
+                                   void *x, void *y) {
+    const register float zero = 0.0;
+    v2f32 c0, c1, c2, c3;
+    float sum;
 
-    // Allocate space in TCDM
-    local_x = (double *)snrt_l1_next();
-    local_y = local_x + n;
-    partial_sums = local_y + n;
+    snrt_ssr_loop_1d(SNRT_SSR_DM_ALL, 4 * n_groups, sizeof(double));
+    snrt_ssr_read(SNRT_SSR_DM0, SNRT_SSR_1D, x);
+    snrt_ssr_read(SNRT_SSR_DM1, SNRT_SSR_1D, y);
+    snrt_ssr_enable();
 
-    // Copy data in TCDM
-    if (snrt_is_dm_core()) {
-        size_t size = n * sizeof(double);
-        snrt_dma_start_1d(local_x, x, size);
-        snrt_dma_start_1d(local_y, y, size);
-        snrt_dma_wait_all();
+    if (prec == FP32) {
+        asm volatile(
+            "vfcpka.s.s %[c0], %[zero], %[zero] \n"
+            "vfcpka.s.s %[c1], %[zero], %[zero] \n"
+            "vfcpka.s.s %[c2], %[zero], %[zero] \n"
+            "vfcpka.s.s %[c3], %[zero], %[zero] \n"
+            "frep.o %[n_frep], 4, 0, 0 \n"
+            "vfmac.s %[c0], ft0, ft1 \n"
+            "vfmac.s %[c1], ft0, ft1 \n"
+            "vfmac.s %[c2], ft0, ft1 \n"
+            "vfmac.s %[c3], ft0, ft1 \n"
+            : [ c0 ] "=&f"(c0), [ c1 ] "=&f"(c1), [ c2 ] "=&f"(c2),
+              [ c3 ] "=&f"(c3)
+            : [ zero ] "f"(zero), [ n_frep ] "r"(n_groups - 1)
+            : "ft0", "ft1", "ft2");
+    } else {
+        asm volatile(
+            "vfcpka.s.s %[c0], %[zero], %[zero] \n"
+            "vfcpka.s.s %[c1], %[zero], %[zero] \n"
+            "vfcpka.s.s %[c2], %[zero], %[zero] \n"
+            "vfcpka.s.s %[c3], %[zero], %[zero] \n"
+            "frep.o %[n_frep], 4, 0, 0 \n"
+            "vfdotpex.s.h %[c0], ft0, ft1 \n"
+            "vfdotpex.s.h %[c1], ft0, ft1 \n"
+            "vfdotpex.s.h %[c2], ft0, ft1 \n"
+            "vfdotpex.s.h %[c3], ft0, ft1 \n"
+            : [ c0 ] "=&f"(c0), [ c1 ] "=&f"(c1), [ c2 ] "=&f"(c2),
+              [ c3 ] "=&f"(c3)
+            : [ zero ] "f"(zero), [ n_frep ] "r"(n_groups - 1)
+            : "ft0", "ft1", "ft2");
     }
 
-    // Calculate size and pointers for each core
-    int core_idx = snrt_cluster_core_idx();
-    int frac_core = n / snrt_cluster_compute_core_num();
-    int offset_core = core_idx * frac_core;
-    local_x += offset_core;
-    local_y += offset_core;
+    snrt_fpu_fence();
+    snrt_ssr_disable();
 
-    snrt_cluster_hw_barrier();
+    // Sum-reduce the accumulators and their lanes
+    asm volatile(
+        "vfadd.s %[c0], %[c0], %[c1] \n"
+        "vfadd.s %[c2], %[c2], %[c3] \n"
+        "vfadd.s %[c0], %[c0], %[c2] \n"
+        "fmv.s %[sum], %[zero] \n"
+        "vfsum.s %[sum], %[c0] \n"
+        : [ c0 ] "+f"(c0), [ c2 ] "+f"(c2), [ sum ] "=&f"(sum)
+        : [ c1 ] "f"(c1), [ c3 ] "f"(c3), [ zero ] "f"(zero)
+        :);
+    return sum;
+}
+
+// Accumulates `instr` over the absolute values of 4 * n_groups elements of
+// x. Both SSRs stream x, as `fsgnjx.d` of an element with itself yields its
+// absolute value.
+#define _DOT_ABS_FREP(instr, n_groups, c0, c1, c2, c3)                   \
+    asm volatile(                                                        \
+        "frep.o %[n_frep], 8, 0, 0 \n"                                   \
+        "fsgnjx.d ft4, ft0, ft1 \n"                                      \
+        "fsgnjx.d ft5, ft0, ft1 \n"                                      \
+        "fsgnjx.d ft6, ft0, ft1 \n"                                      \
+        "fsgnjx.d ft7, ft0, ft1 \n" instr " %[c0], %[c0], ft4 \n" instr \
+        " %[c1], %[c1], ft5 \n" instr " %[c2], %[c2], ft6 \n" instr      \
+        " %[c3], %[c3], ft7 \n"                                          \
+        : [ c0 ] "+f"(c0), [ c1 ] "+f"(c1), [ c2 ] "+f"(c2),             \
+          [ c3 ] "+f"(c3)                                                \
+        : [ n_frep ] "r"((n_groups)-1)                                   \
+        : "ft0", "ft1", "ft2", "ft4", "ft5", "ft6", "ft7")
 
-    start_cycle = snrt_mcycle();
+typedef enum { DOT_OP_DOT, DOT_OP_ASUM, DOT_OP_IAMAX } dot_op_t;
+
+// Partial result of a core or cluster. `idx` is only used by iamax.
+typedef struct {
+    double val;
+    uint32_t idx;
+    uint32_t reserved;
+} dot_partial_t;
+
+// Size in bytes of the chunks in which the vectors are streamed from L3.
+// Every vector is double buffered in TCDM.
+#ifndef DOT_CHUNK_SIZE
+#define DOT_CHUNK_SIZE 4096
+#endif
 
-    // Compute partial sums
-    if (snrt_is_compute_core()) {
-        dot_seq_4_acc(frac_core, local_x, local_y, &partial_sums[core_idx]);
+// Distributes n elements in groups of `lanes` over `num` parts as evenly as
+// possible. The first parts get one group more than the others, and the
+// last part additionally gets the elements which don't fill a whole group.
+static inline void dot_split(uint32_t n, uint32_t lanes, uint32_t part,
+                             uint32_t num, uint32_t *start, uint32_t *len) {
+    uint32_t n_groups = n / lanes;
+    uint32_t frac = n_groups / num;
+    uint32_t rem = n_groups % num;
+    *start = lanes * (part * frac + (part < rem ? part : rem));
+    *len = lanes * (frac + (part < rem));
+    if (part == num - 1) *len += n % lanes;
+}
+
+// Accumulates the contribution of n elements of a TCDM chunk, starting at
+// element `offset` of the vector, into a core's partial result.
+static inline void dot_chunk(dot_op_t op, precision_t prec, uint32_t n,
+                             void *x, void *y, uint32_t offset,
+                             dot_partial_t *partial) {
+    uint32_t lanes = sizeof(double) / prec;
+    uint32_t n_groups = n / (4 * lanes);
+    uint32_t n_vec = 4 * lanes * n_groups;
+
+    if (op == DOT_OP_DOT && prec != FP64) {
+        float sum = n_groups ? dot_simd_4_acc(prec, n_groups, x, y) : 0;
+        for (uint32_t i = n_vec; i < n; i++) {
+            if (prec == FP32)
+                sum += ((float *)x)[i] * ((float *)y)[i];
+            else
+                sum += (float)((__fp16 *)x)[i] * (float)((__fp16 *)y)[i];
+        }
+        partial->val += sum;
+        return;
     }
 
-    snrt_cluster_hw_barrier();
+    double *xd = (double *)x;
+    double *yd = (double *)y;
+    double res = 0;
+    if (n_groups) {
+        if (op == DOT_OP_DOT) {
+            dot_seq_4_acc(n_vec, xd, yd, &res);
+        } else {
+            double c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+            snrt_ssr_loop_1d(SNRT_SSR_DM_ALL, n_vec, sizeof(double));
+            snrt_ssr_read(SNRT_SSR_DM0, SNRT_SSR_1D, xd);
+            snrt_ssr_read(SNRT_SSR_DM1, SNRT_SSR_1D, xd);
+            snrt_ssr_enable();
+            if (op == DOT_OP_ASUM)
+                _DOT_ABS_FREP("fadd.d", n_groups, c0, c1, c2, c3);
+            else
+                _DOT_ABS_FREP("fmax.d", n_groups, c0, c1, c2, c3);
+            snrt_fpu_fence();
+            snrt_ssr_disable();
 
-    // Reduce partial sums on core 0
-#ifndef _DOTP_EXCLUDE_FINAL_SYNC_
-    if (snrt_cluster_core_idx() == 0) {
-        for (uint32_t i = 1; i < snrt_cluster_compute_core_num(); i++) {
-            partial_sums[0] += partial_sums[i];
+            // Reduce the accumulators, after the SSRs release ft0-ft2
+            if (op == DOT_OP_ASUM) {
+                res = (c0 + c1) + (c2 + c3);
+            } else {
+                c0 = c0 > c1 ? c0 : c1;
+                c2 = c2 > c3 ? c2 : c3;
+                res = c0 > c2 ? c0 : c2;
+            }
         }
-        snrt_fpu_fence();
     }
-#endif
 
-    end_cycle = snrt_mcycle();
+    // Remainder which doesn't fill the unrolled loop
+    for (uint32_t i = n_vec; i < n; i++) {
+        double abs_x = xd[i] < 0 ? -xd[i] : xd[i];
+        if (op == DOT_OP_DOT)
+            res += xd[i] * yd[i];
+        else if (op == DOT_OP_ASUM)
+            res += abs_x;
+        else if (abs_x > res)
+            res = abs_x;
+    }
+
+    if (op != DOT_OP_IAMAX) {
+        partial->val += res;
+    } else if (res > partial->val) {
+        // Chunks are processed in order, so only a strictly greater
+        // maximum can move the first occurrence. Locate it in the chunk,
+        // without running past it if the chunk only holds NaNs.
+        uint32_t i = 0;
+        while (i + 1 < n && (xd[i] < 0 ? -xd[i] : xd[i]) != res) i++;
+        partial->val = res;
+        partial->idx = offset + i;
+    }
+}
+
+// Combines the partial results of two cores or clusters.
+static inline void dot_combine(dot_op_t op, dot_partial_t *acc,
+                               const dot_partial_t *partial) {
+    if (op != DOT_OP_IAMAX) {
+        acc->val += partial->val;
+    } else if (partial->val > acc->val ||
+               (partial->val == acc->val && partial->idx < acc->idx)) {
+        *acc = *partial;
+    }
+}
+
+// Streams x (and y, if not null) from L3 through TCDM and reduces them to
+// a single partial result, which is returned in cluster 0's compute core 0.
+// The vectors are split evenly over all clusters, and every cluster streams
+// its part in chunks of DOT_CHUNK_SIZE bytes, loading the next chunk while
+// all compute cores work on the current one. The partial results of the
+// cores are combined by core 0, and the results of the clusters by an
+// inter-cluster DMA reduction, or for iamax, where the index must follow the
+// maximum, by an all-gather. Must be called by all cores in all clusters.
+static inline void dot_stream(dot_op_t op, precision_t prec, uint32_t n,
+                              void *x, void *y, dot_partial_t *result) {
+    uint32_t core_idx = snrt_cluster_core_idx();
+    uint32_t num_cores = snrt_cluster_compute_core_num();
+    uint32_t num_clusters = snrt_cluster_num();
+    uint32_t lanes = sizeof(double) / prec;
+    uint32_t num_vecs = y ? 2 : 1;
 
+    // Allocate double buffers and partial results at the same offset in
+    // the TCDM of every cluster, as required by the inter-cluster reduction
+    void *buffers = snrt_l1_alloc_cluster_local(2 * num_vecs * DOT_CHUNK_SIZE,
+                                                sizeof(double));
+    dot_partial_t *partials = snrt_l1_alloc_cluster_local(
+        num_cores * sizeof(dot_partial_t), sizeof(double));
+    dot_partial_t *reduction = snrt_l1_alloc_cluster_local(
+        (num_clusters + 1) * sizeof(dot_partial_t), sizeof(double));
+
+    // Part of the vectors assigned to this cluster
+    uint32_t cluster_start, cluster_len;
+    dot_split(n, lanes, snrt_cluster_idx(), num_clusters, &cluster_start,
+              &cluster_len);
+    uint32_t chunk_len = DOT_CHUNK_SIZE / prec;
+    uint32_t n_chunks = (cluster_len + chunk_len - 1) / chunk_len;
+
+    dot_partial_t partial = {op == DOT_OP_IAMAX ? -1 : 0, 0, 0};
+
+    // Prefetch the first chunk
+    if (snrt_is_dm_core() && n_chunks) {
+        size_t size =
+            (cluster_len < chunk_len ? cluster_len : chunk_len) * prec;
+        snrt_dma_start_1d(buffers, x + cluster_start * prec, size);
+        if (y)
+            snrt_dma_start_1d(buffers + DOT_CHUNK_SIZE,
+                              y + cluster_start * prec, size);
+    }
+
+    for (uint32_t c = 0; c < n_chunks; c++) {
+        uint32_t chunk_start = c * chunk_len;
+        uint32_t len = cluster_len - chunk_start;
+        if (len > chunk_len) len = chunk_len;
+        void *x_buf = buffers + (c % 2) * num_vecs * DOT_CHUNK_SIZE;
+        void *y_buf = y ? x_buf + DOT_CHUNK_SIZE : x_buf;
+
+        // Wait for the current chunk. The barrier also ensures that all
+        // cores are done with the previous chunk, whose buffer is refilled.
+        if (snrt_is_dm_core()) snrt_dma_wait_all();
+        snrt_cluster_hw_barrier();
+
+        if (snrt_is_dm_core() && c + 1 < n_chunks) {
+            uint32_t next_start = chunk_start + chunk_len;
+            uint32_t next_len = cluster_len - next_start;
+            if (next_len > chunk_len) next_len = chunk_len;
+            void *next_x_buf =
+                buffers + ((c + 1) % 2) * num_vecs * DOT_CHUNK_SIZE;
+            size_t offset = (cluster_start + next_start) * prec;
+            snrt_dma_start_1d(next_x_buf, x + offset, next_len * prec);
+            if (y)
+                snrt_dma_start_1d(next_x_buf + DOT_CHUNK_SIZE, y + offset,
+                                  next_len * prec);
+        }
+
+        if (snrt_is_compute_core()) {
+            uint32_t core_start, core_len;
+            dot_split(len, lanes, core_idx, num_cores, &core_start, &core_len);
+            if (core_len)
+                dot_chunk(op, prec, core_len, x_buf + core_start * prec,
+                          y_buf + core_start * prec,
+                          cluster_start + chunk_start + core_start, &partial);
+        }
+    }
+
+    // Combine the partial results of the cores
+    if (snrt_is_compute_core()) partials[core_idx] = partial;
+    snrt_cluster_hw_barrier();
+    if (core_idx == 0) {
+        for (uint32_t i = 1; i < num_cores; i++)
+            dot_combine(op, &partial, &partials[i]);
+        reduction[num_clusters] = partial;
+    }
     snrt_cluster_hw_barrier();
 
-    // Copy data out of TCDM
-    if (snrt_is_dm_core()) {
-        *result = partial_sums[0];
+    // Combine the partial results of the clusters
+    if (op != DOT_OP_IAMAX) {
+        snrt_global_reduction_dma(&reduction[0].val,
+                                  &reduction[num_clusters].val, 1);
+    } else {
+        snrt_allgather(reduction, &reduction[num_clusters],
+                       sizeof(dot_partial_t));
+        snrt_cluster_hw_barrier();
+        if (core_idx == 0) {
+            for (uint32_t i = 1; i < num_clusters; i++)
+                dot_combine(op, &reduction[0], &reduction[i]);
+        }
     }
 
+    if (snrt_cluster_idx() == 0 && core_idx == 0) *result = reduction[0];
+    snrt_fpu_fence();
+    snrt_l1_update_next_v2(buffers);
     snrt_cluster_hw_barrier();
 }
+
+// Dot product of two vectors in FP64, FP32 or FP16, of arbitrary length and
+// location. The result is accumulated in FP32 for the packed-SIMD
+// precisions, and in FP64 across cores and clusters. It is written by
+// cluster 0. Must be called by all cores in all clusters.
+static inline void dot_generic(precision_t prec, uint32_t n, void *x, void *y,
+                               double *result) {
+    dot_partial_t res;
+    dot_stream(DOT_OP_DOT, prec, n, x, y, &res);
+    if (snrt_cluster_idx() == 0 && snrt_cluster_core_idx() == 0)
+        *result = res.val;
+}
+
+static inline void dot(uint32_t n, double *x, double *y, double *result) {
+    dot_generic(FP64, n, x, y, result);
+}
+
+// Euclidean norm of x. Unlike the reference BLAS, the sum of squares is not
+// scaled, which is only a concern for elements beyond 1e154 in magnitude.
+static inline void nrm2(uint32_t n, double *x, double *result) {
+    dot_partial_t res;
+    dot_stream(DOT_OP_DOT, FP64, n, x, NULL, &res);
+    if (snrt_cluster_idx() == 0 && snrt_cluster_core_idx() == 0) {
+        double norm;
+        asm volatile("fsqrt.d %[norm], %[sum] \n"
+                     : [ norm ] "=f"(norm)
+                     : [ sum ] "f"(res.val));
+        *result = norm;
+    }
+}
+
+// Sum of the absolute values of x.
+static inline void asum(uint32_t n, double *x, double *result) {
+    dot_partial_t res;
+    dot_stream(DOT_OP_ASUM, FP64, n, x, NULL, &res);
+    if (snrt_cluster_idx() == 0 && snrt_cluster_core_idx() == 0)
+        *result = res.val;
+}
+
+// Index of the first element of x with the largest absolute value. Unlike
+// the reference BLAS, indices start from zero.
+static inline void iamax(uint32_t n, double *x, uint32_t *result) {
+    dot_partial_t res;
+    dot_stream(DOT_OP_IAMAX, FP64, n, x, NULL, &res);
+    if (snrt_cluster_idx() == 0 && snrt_cluster_core_idx() == 0)
+        *result = res.idx;
+}
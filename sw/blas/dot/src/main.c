@@ -8,19 +8,29 @@
 #include "dot.h"
 
 int main() {
-    dot(n, x, y, &result);
+    uint32_t index;
+
+    dot(n, x, y, &result[0]);
+    nrm2(n, x, &result[1]);
+    asum(n, x, &result[2]);
+    iamax(n, x, &index);
+    dot_generic(FP32, n, x_fp32, y_fp32, &result[4]);
+    dot_generic(FP16, n, x_fp16, y_fp16, &result[5]);
+
+    if (snrt_global_core_idx() == 0) result[3] = index;
 
-// TODO: currently only works for single cluster otherwise need to
-//       synchronize all cores here
 #ifdef BIST
-    uint32_t nerr = 1;
+    uint32_t nerr = 0;
 
     // Check computation is correct
     if (snrt_global_core_idx() == 0) {
-        if (result == g) nerr--;
+        for (uint32_t i = 0; i < 6; i++) {
+            double diff = result[i] - g[i];
+            double tol = (i < 4 ? 1e-10 : 1e-2) * (g[i] < 0 ? -g[i] : g[i]);
+            nerr += diff > tol || diff < -tol;
+        }
         return nerr;
     }
-
 #endif
 
     return 0;
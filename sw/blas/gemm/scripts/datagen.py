@@ -8,7 +8,9 @@
 #          Viviane Potocnik <vivianep@iis.ee.ethz.ch>
 #          Luca Colagrande <colluca@iis.ee.ethz.ch>
 
+from math import ceil, isqrt
 import numpy as np
+import pyflexfloat as ff
 import re
 import sys
 
@@ -28,55 +30,150 @@ class GemmDataGen(du.DataGen):
         return alpha * np.matmul(a, b) + beta * c
 
     def exact_golden_model(self, alpha, a, b, beta, c):
+        # Integer GEMMs accumulate exactly in 32-bit integers
+        if np.issubdtype(c.dtype, np.integer):
+            return np.matmul(a.astype(np.int32), b.astype(np.int32)) + beta * c
+        # Mirrors the order of operations in gemm(), where C is prescaled by
+        # beta / alpha and the result is scaled by alpha
         M, N, K = a.shape[0], b.shape[1], b.shape[0]
-        result = beta * c
+        result = beta / alpha * c
         for m in range(M):
             for n in range(N):
                 for k in range(K):
                     result[m][n] += a[m][k] * b[k][n]
-        return result
+        return alpha * result
+
+    # Encodings of gemm_bias_t and gemm_act_t
+    BIAS_TYPES = ['none', 'row', 'col']
+    ACTIVATIONS = ['none', 'relu', 'gelu']
+
+    @staticmethod
+    def gelu(x):
+        # Mirrors gemm_gelu() in gemm.h
+        a, b = -0.2888, -1.769
+        sign = np.where(x > 0, 1.0, -1.0)
+        arg = np.minimum(np.abs(x * 0.7071067811865476), -b)
+        return x * 0.5 * (1.0 + sign * (a * (arg + b)**2 + 1.0))
+
+    @staticmethod
+    def convert(x, prec):
+        # Mirrors gemm_epilogue_store() in gemm.h. Integers are rounded to
+        # the nearest, ties away from zero, and saturated.
+        ctype = du.ctype_from_precision_t(prec)
+        if ctype == '__fp8':
+            return ff.array(x.astype(np.float32), du.ff_desc_from_precision_t(prec))
+        dtype = du.numpy_type_from_precision_t(prec)
+        if np.issubdtype(dtype, np.integer):
+            info = np.iinfo(dtype)
+            x = np.where(x >= 0, np.floor(x + 0.5), np.ceil(x - 0.5))
+            return np.clip(x, info.min, info.max).astype(dtype)
+        if dtype == np.float64:
+            return x
+        return x.astype(np.float32).astype(dtype)
+
+    def epilogue_golden_model(self, alpha, a, b, beta, c, bias_type, bias, act, out_prec):
+        # Mirrors gemm(): C is accumulated in its own precision, after
+        # prescaling it by beta / alpha for floating-point GEMMs, and the
+        # epilogue is applied in double precision
+        if np.issubdtype(c.dtype, np.integer):
+            acc = self.exact_golden_model(1, a, b, int(beta != 0), c)
+        else:
+            acc = self.exact_golden_model(1, a, b, beta / alpha, c)
+        x = alpha * acc.astype(np.float64)
+        if self.BIAS_TYPES[bias_type] == 'row':
+            x += bias.astype(np.float64)[:, np.newaxis]
+        elif self.BIAS_TYPES[bias_type] == 'col':
+            x += bias.astype(np.float64)[np.newaxis, :]
+        if self.ACTIVATIONS[act] == 'relu':
+            x = np.maximum(x, 0.0)
+        elif self.ACTIVATIONS[act] == 'gelu':
+            x = self.gelu(x)
+        return self.convert(x, out_prec)
+
+    def generate_bias(self, M, N, bias_type, prec_c, seed):
+        length = M if bias_type == 'row' else N
+        if prec_c & 0x10:
+            rng = np.random.default_rng(seed=seed)
+            return rng.integers(-64, 64, size=length, endpoint=True).astype(np.int32)
+        return du.generate_random_array((length,), prec_c, seed=seed)
 
     def infer_implementation(self, gemm_fp):
-        # gemm_fp: "gemm_fp64_opt"
-        # create a regex with fp_<type>_<implementation>
-        prec, impl = re.search(r'gemm_fp(\d+)_(\w+)', gemm_fp).group(1, 2)
-        return (int(prec) / 8), impl
+        # gemm_fp: "gemm_fp64_opt" or "gemm_i8_opt"
+        # create a regex with <fp|i><width>_<implementation>
+        kind, width, impl = re.search(r'gemm_(fp|i)(\d+)_(\w+)', gemm_fp).group(1, 2, 3)
+        prec = int(width) // 8
+        if kind == 'i':
+            prec |= 0x10
+        return prec, impl
+
+    def generate_integer_operands(self, M, N, K, prec, seed):
+        # Bound the operands so that the INT32 accumulation cannot overflow
+        dtype = du.numpy_type_from_precision_t(prec)
+        bound = min(np.iinfo(dtype).max, isqrt((2**31 - 1) // (K + 1)))
+        rng = np.random.default_rng(seed=seed)
+        a = rng.integers(-bound, bound, size=(M, K), endpoint=True).astype(dtype)
+        b = rng.integers(-bound, bound, size=(K, N), endpoint=True).astype(dtype)
+        c = rng.integers(-bound**2, bound**2, size=(M, N), endpoint=True).astype(np.int32)
+        return a, b, c
 
     def validate(self, gemm_fp, parallelize_m,
                  parallelize_k, m_tiles, n_tiles, k_tiles, transa,
-                 transb, M, N, K, beta, **kwargs):
-        frac_m = M / m_tiles
-        frac_n = N / n_tiles
-        frac_k = K / k_tiles
+                 transb, M, N, K, beta, parallelize_n=0, epilogue=None, **kwargs):
+        # Tiles are sized by rounding up, the last tile in every dimension
+        # covers the remainder
+        frac_m = ceil(M / m_tiles)
+        frac_n = ceil(N / n_tiles)
+        frac_k = ceil(K / k_tiles)
+        last_n = N - (ceil(N / frac_n) - 1) * frac_n
 
         dtype, impl = self.infer_implementation(gemm_fp)
 
         # Calculate total TCDM occupation
         # Note: doesn't account for double buffering
+        is_int = bool(dtype & 0x10)
         prec = du.size_from_precision_t(dtype)
         a_size = frac_m * frac_k * prec
         b_size = frac_k * frac_n * prec
-        c_size = frac_m * frac_n * prec
+        c_size = frac_m * frac_n * (4 if is_int else prec)
         total_size = a_size
         total_size += b_size
         total_size += c_size
+        if parallelize_k:
+            total_size += c_size
+        if epilogue is not None and epilogue.get('bias', 'none') != 'none':
+            bias_len = frac_m if epilogue['bias'] == 'row' else frac_n
+            total_size += bias_len * (4 if is_int else prec)
         du.validate_tcdm_footprint(total_size)
 
-        assert (M % m_tiles) == 0, 'M is not an integer multiple of tile size'
-        assert (N % n_tiles) == 0, 'N is not an integer multiple of tile size'
-        assert (K % k_tiles) == 0, 'K is not an integer multiple of tile size'
-        assert not (parallelize_m and parallelize_k), 'Cannot parallelize K and M simultaneously'
+        assert m_tiles <= M and n_tiles <= N and k_tiles <= K, \
+            'Number of tiles cannot exceed the dimension size'
         assert not transa, 'SIMD kernels don\'t support transposed A matrix'
-        assert (dtype == 8) or (impl == 'baseline') or (impl == 'naive') \
+        assert (dtype == 8) or is_int or (impl == 'baseline') or (impl == 'naive') \
             or transb, 'Optimized SIMD kernels only support transposed B matrix'
-        assert not transb or n_tiles == 1, 'Tiling in the N dimension not supported' \
-            ' if B is transposed'
-        assert not transb or k_tiles == 1, 'Tiling in the K dimension not supported' \
-            ' if B is transposed'
-        assert (impl == 'baseline') or (impl == 'naive') or frac_n >= 8, \
+        assert is_int or (impl == 'baseline') or (impl == 'naive') or (impl == 'opt_rb') or \
+            last_n >= 8, \
             'N dimension of tile size must be greater or equal to the unrolling factor (8) ' \
             'when using optimized kernels'
         assert beta == 0 or beta == 1, 'Only values of 0 or 1 supported for beta'
+        if epilogue is None:
+            assert not is_int or kwargs['alpha'] == 1, 'Integer GEMMs only support alpha = 1'
+        else:
+            assert is_int or dtype in (8, 4), 'Epilogues only support FP64, FP32 and INT32 C'
+            assert kwargs['alpha'] != 0, 'Epilogues require a non-zero alpha'
+            epi_beta = epilogue.get('beta', 0)
+            assert not is_int or epi_beta in (0, kwargs['alpha']), \
+                'Integer GEMMs only support an epilogue beta of 0 or alpha'
+            assert epilogue.get('bias', 'none') in self.BIAS_TYPES, 'Unknown bias type'
+            assert epilogue.get('act', 'none') in self.ACTIVATIONS, 'Unknown activation'
+            prec_c = 0x14 if is_int else dtype
+            out_prec = epilogue.get('out_prec', prec_c)
+            assert du.size_from_precision_t(out_prec) <= du.size_from_precision_t(prec_c), \
+                'The output precision cannot be wider than C'
+            assert kwargs['load_c'] or \
+                du.ctype_from_precision_t(out_prec) == du.ctype_from_precision_t(prec_c), \
+                'Conversion to a lower output precision requires load_c'
+        assert not is_int or impl in ('naive', 'opt'), 'Integer GEMMs only implemented in' \
+            ' naive and optimized implementations'
         assert not (dtype == 8 and impl == "baseline"), 'No baseline implemented' \
             ' for FP64 (switch to NAIVE)'
         assert not (((dtype == 8) or (dtype == 4)) and impl == "opt_ex"), \
@@ -90,18 +187,38 @@ class GemmDataGen(du.DataGen):
         header = [super().emit_header()]
 
         # Validate parameters
-        self.validate(**kwargs)
+        epilogue = kwargs.pop('epilogue', None)
+        self.validate(epilogue=epilogue, **kwargs)
 
         M, N, K = kwargs['M'], kwargs['N'], kwargs['K']
 
         prec, _ = self.infer_implementation(kwargs['gemm_fp'])
 
         ctype = du.ctype_from_precision_t(prec)
+        # Integer GEMMs produce an INT32 C matrix
+        ctype_c = du.ctype_from_precision_t('INT32') if prec & 0x10 else ctype
 
-        a = du.generate_random_array((M, K), prec, seed=42)
-        b = du.generate_random_array((K, N), prec, seed=42)
-        c = du.generate_random_array((M, N), prec, seed=42)
-        result = self.exact_golden_model(1, a, b, kwargs['beta'], c)
+        if prec & 0x10:
+            a, b, c = self.generate_integer_operands(M, N, K, prec, seed=42)
+        else:
+            a = du.generate_random_array((M, K), prec, seed=42)
+            b = du.generate_random_array((K, N), prec, seed=42)
+            c = du.generate_random_array((M, N), prec, seed=42)
+        if epilogue is None:
+            result = self.exact_golden_model(kwargs['alpha'], a, b, kwargs['beta'], c)
+        else:
+            # The epilogue writes its output to a separate array
+            prec_c = 0x14 if prec & 0x10 else prec
+            bias_type = epilogue.get('bias', 'none')
+            act = epilogue.get('act', 'none')
+            out_prec = epilogue.get('out_prec', prec_c)
+            ctype_out = du.ctype_from_precision_t(out_prec)
+            bias = None
+            if bias_type != 'none':
+                bias = self.generate_bias(M, N, bias_type, prec_c, seed=43)
+            result = self.epilogue_golden_model(
+                kwargs['alpha'], a, b, epilogue.get('beta', 0), c,
+                self.BIAS_TYPES.index(bias_type), bias, self.ACTIVATIONS.index(act), out_prec)
 
         # Store matrices in transposed form if requested
         a = a.T if kwargs['transa'] else a
@@ -118,6 +235,16 @@ class GemmDataGen(du.DataGen):
             'b': b_uid,
             'c': c_uid,
         }
+        if epilogue is not None:
+            cfg['epilogue'] = '&epi'
+            epi = {
+                'beta': epilogue.get('beta', 0),
+                'bias': f'GEMM_BIAS_{bias_type.upper()}',
+                'act': f'GEMM_ACT_{act.upper()}',
+                'bias_ptr': None if bias is None else 'bias',
+                'out_prec': out_prec,
+                'out': 'out',
+            }
 
         a = a.flatten()
         b = b.flatten()
@@ -125,15 +252,26 @@ class GemmDataGen(du.DataGen):
 
         header += [du.format_array_declaration(ctype, a_uid, a.shape)]
         header += [du.format_array_declaration(ctype, b_uid, b.shape)]
-        header += [du.format_array_declaration(ctype, c_uid, c.shape)]
+        header += [du.format_array_declaration(ctype_c, c_uid, c.shape)]
+        if epilogue is not None:
+            if bias is not None:
+                header += [du.format_array_declaration(ctype_c, 'bias', bias.shape)]
+            header += [du.format_array_declaration(ctype_out, 'out', c.shape,
+                                                   section=kwargs['section'])]
+            header += [du.format_struct_definition('gemm_epilogue_t', 'epi', epi)]
         header += [du.format_struct_definition('gemm_args_t', 'args', cfg)]
         header += [du.format_array_definition(ctype, a_uid, a,
                                               section=kwargs['section'])]
         header += [du.format_array_definition(ctype, b_uid, b,
                                               section=kwargs['section'])]
-        header += [du.format_array_definition(ctype, c_uid, c,
+        header += [du.format_array_definition(ctype_c, c_uid, c,
                                               section=kwargs['section'])]
-        result_def = du.format_array_definition(ctype, 'result', result.flatten())
+        if epilogue is not None:
+            if bias is not None:
+                header += [du.format_array_definition(ctype_c, 'bias', bias,
+                                                      section=kwargs['section'])]
+            ctype_c = ctype_out
+        result_def = du.format_array_definition(ctype_c, 'result', result.flatten())
         header += [du.format_ifdef_wrapper('BIST', result_def)]
         header = '\n\n'.join(header)
 
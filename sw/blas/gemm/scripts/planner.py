@@ -0,0 +1,315 @@
+#!/usr/bin/env python3
+# Copyright 2024 ETH Zurich and University of Bologna.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+"""Plan the tiling and parallelization of a GEMM.
+
+Host-side counterpart of `gemm_plan()` in `gemm.h`, using the same
+performance model. Given the problem shape, precision, number of clusters
+and TCDM size, the `plan` command chooses the tiling which minimizes the
+predicted cycles, among those fitting in TCDM with double buffering, and
+optionally emits it as a GEMM configuration file.
+
+The `sweep` command plans all points of a sweep specification, i.e. the
+combinations of a set of shapes, precisions and cluster counts, and emits
+their configuration files, to be built and simulated with the GEMM
+application (see `target/snitch_cluster/sw/apps/blas/gemm/sweep`).
+
+The `validate` command compares the model against the cycles measured by the
+GEMM application, as reported in its simulation logs. With `--fit`, it also
+calibrates the model constants on the measured cycles by least squares.
+"""
+
+import argparse
+import itertools
+import json
+import json5
+import numpy as np
+import pathlib
+import re
+import sys
+
+from snitch.blas.gemm.scripts.sweep import ceil_div, cluster_grid
+import snitch.util.sim.data_utils as du
+
+# Parameters of the performance model, see gemm.h for their derivation
+DMA_BW = 64
+DMA_LATENCY = 60
+KERNEL_OVERHEAD = 100
+BLOCK_OVERHEAD = 20
+SYNC_OVERHEAD = 40
+
+# Default kernel for every precision
+KERNELS = {8: 'gemm_fp64_opt', 4: 'gemm_fp32_opt', 2: 'gemm_fp16_opt', 1: 'gemm_fp8_opt_ex'}
+
+# sizeof(gemm_args_t) and sizeof(gemm_epilogue_t) on RV32
+GEMM_ARGS_SIZE = 96
+GEMM_EPILOGUE_SIZE = 32
+
+
+# Model constants calibrated by `validate --fit`. The DMA bandwidth is a
+# property of the hardware, so it is not fitted.
+FITTED = ['DMA_LATENCY', 'KERNEL_OVERHEAD', 'BLOCK_OVERHEAD', 'SYNC_OVERHEAD']
+
+
+def model_terms(M, N, K, prec, m_tiles, n_tiles, k_tiles, grid, num_cores):
+    """Decompose the predicted cycles into a fixed part and the number of times
+    each of the FITTED constants is incurred."""
+    frac_m, frac_n, frac_k = ceil_div(M, m_tiles), ceil_div(N, n_tiles), ceil_div(K, k_tiles)
+    lanes = 8 // prec
+    size_c = frac_m * frac_n * prec
+    blocks = ceil_div(frac_m, num_cores) * ceil_div(frac_n, 8)
+    levels = (grid[2] - 1).bit_length()
+
+    # Every K iteration loads the A and B tiles, runs the kernel and
+    # synchronizes
+    iteration = [ceil_div(frac_m * frac_k * prec, DMA_BW) + ceil_div(frac_k * frac_n * prec, DMA_BW)
+                 + blocks * 8 * ceil_div(frac_k, lanes), 2, 1, blocks, 1]
+    # Every output tile is loaded, reduced over the levels of the K grid, and
+    # stored
+    output = [(2 + levels) * ceil_div(size_c, DMA_BW) +
+              levels * ceil_div(frac_m * frac_n, num_cores), 2 + levels, 0, 0, levels]
+
+    num_outputs = ceil_div(m_tiles, grid[0]) * ceil_div(n_tiles, grid[1])
+    k_iterations = ceil_div(k_tiles, grid[2])
+    terms = [num_outputs * (k_iterations * i + o) for i, o in zip(iteration, output)]
+    return terms[0], terms[1:]
+
+
+def predict_cycles(M, N, K, prec, m_tiles, n_tiles, k_tiles, grid, num_cores, constants=None):
+    if constants is None:
+        constants = [globals()[name] for name in FITTED]
+    fixed, counts = model_terms(M, N, K, prec, m_tiles, n_tiles, k_tiles, grid, num_cores)
+    return fixed + sum(n * c for n, c in zip(counts, constants))
+
+
+def align_up(x, a=8):
+    return ceil_div(x, a) * a
+
+
+def footprint(M, N, K, prec, m_tiles, n_tiles, k_tiles, grid, epilogue=None):
+    """TCDM footprint of a tiling, including the epilogue and its bias slice.
+
+    `epilogue` is None if the GEMM has no epilogue, or the type of its bias:
+    'none', 'row' or 'col'.
+    """
+    frac_m, frac_n, frac_k = ceil_div(M, m_tiles), ceil_div(N, n_tiles), ceil_div(K, k_tiles)
+    size_c = align_up(frac_m * frac_n * prec)
+    size_epi = 0
+    if epilogue is not None:
+        size_epi = align_up(GEMM_EPILOGUE_SIZE)
+        if epilogue != 'none':
+            size_epi += align_up((frac_m if epilogue == 'row' else frac_n) * prec)
+    return align_up(GEMM_ARGS_SIZE) + size_epi + 2 * align_up(frac_m * frac_k * prec) + \
+        2 * align_up(frac_k * frac_n * prec) + size_c + (size_c if grid[2] > 1 else 0)
+
+
+def tile_candidates(dim):
+    tiles = 1
+    while tiles <= dim:
+        yield tiles
+        tiles = 2 if tiles == 1 else (tiles + tiles // 3 if tiles & (tiles - 1)
+                                      else tiles + tiles // 2)
+
+
+def tiles_aligned(dim, tiles, multiple):
+    frac = ceil_div(dim, tiles)
+    last = dim - (ceil_div(dim, frac) - 1) * frac
+    return frac % multiple == 0 and last % multiple == 0
+
+
+def effective_tiles(dim, tiles):
+    return ceil_div(dim, ceil_div(dim, tiles))
+
+
+def plan(M, N, K, prec, num_clusters, tcdm_size, num_cores=8, transb=True, epilogue=None):
+    """Return the configuration minimizing the predicted cycles, or None."""
+    simd = prec != 8
+    if simd and not transb:
+        return None
+    parallelize = int(num_clusters > 1)
+    best = None
+    for mt, nt, kt in itertools.product(tile_candidates(M), tile_candidates(N),
+                                        tile_candidates(K)):
+        if simd and not (tiles_aligned(N, nt, 8) and tiles_aligned(K, kt, 8 // prec)):
+            continue
+        tiles = (effective_tiles(M, mt), effective_tiles(N, nt), effective_tiles(K, kt))
+        grid, _ = cluster_grid(*tiles, parallelize, parallelize, parallelize, num_clusters)
+        if footprint(M, N, K, prec, *tiles, grid, epilogue) > tcdm_size:
+            continue
+        cycles = predict_cycles(M, N, K, prec, *tiles, grid, num_cores)
+        if best is None or cycles < best[0]:
+            best = (cycles, tiles, grid)
+    if best is None:
+        return None
+
+    cycles, tiles, grid = best
+    # gemm_fp64_opt only supports N tiles which are multiples of its unrolling
+    # factor, for any layout of B. Other tiles require the register-blocked
+    # kernel.
+    kernel = KERNELS[prec]
+    if prec == 8 and not tiles_aligned(N, tiles[1], 8):
+        kernel = 'gemm_fp64_opt_rb'
+    cfg = {
+        'setup_ssr': 1,
+        'parallelize_m': parallelize,
+        'parallelize_n': parallelize,
+        'parallelize_k': parallelize,
+        'm_tiles': tiles[0],
+        'n_tiles': tiles[1],
+        'k_tiles': tiles[2],
+        'load_a': 1,
+        'load_b': 1,
+        'load_c': 1,
+        'transa': False,
+        'transb': transb,
+        'M': M,
+        'N': N,
+        'K': K,
+        'alpha': 1,
+        'beta': 0,
+        'gemm_fp': kernel,
+    }
+    return cfg, grid, cycles
+
+
+def utilization(M, N, K, prec, cycles, num_clusters, num_cores):
+    return M * N * K / (cycles * num_clusters * num_cores * (8 // prec))
+
+
+def plan_points(points, tcdm_size, num_cores, transb, epilogue, cfg_dir):
+    """Plan every (shape, prec, clusters) point, optionally emitting its
+    configuration file."""
+    print(f'{"shape":>14} {"prec":>4} {"clusters":>8} {"tiles":>10} {"grid":>7} '
+          f'{"cycles":>10} {"util":>6}')
+    for shape, prec, num_clusters in points:
+        M, N, K = [int(x) for x in shape.split('x')]
+        res = plan(M, N, K, prec, num_clusters, tcdm_size, num_cores, transb, epilogue)
+        if res is None:
+            print(f'{shape:>14} {prec:>4} {num_clusters:>8} no feasible tiling')
+            continue
+        cfg, grid, cycles = res
+        tiles = f'{cfg["m_tiles"]}x{cfg["n_tiles"]}x{cfg["k_tiles"]}'
+        util = utilization(M, N, K, prec, cycles, num_clusters, num_cores)
+        print(f'{shape:>14} {prec:>4} {num_clusters:>8} {tiles:>10} '
+              f'{"x".join(map(str, grid)):>7} {cycles:>10} {util:>6.2f}')
+        if cfg_dir:
+            cfg_dir.mkdir(parents=True, exist_ok=True)
+            with open(cfg_dir / f'{shape}-fp{8 * prec}-{num_clusters}.json', 'w') as f:
+                json.dump(cfg, f, indent=4)
+
+
+def cmd_plan(args):
+    points = itertools.product(args.shapes, [args.prec], args.clusters)
+    plan_points(points, args.tcdm_size, args.cores, not args.no_transb, args.epilogue,
+                args.cfg_dir)
+
+
+def cmd_sweep(args):
+    with open(args.spec) as f:
+        spec = json5.load(f)
+    points = itertools.product(spec['shapes'], spec['precs'], spec['clusters'])
+    plan_points(points, spec.get('tcdm_size', du.TCDM_HEAP_SIZE), args.cores,
+                spec.get('transb', True), None, args.cfg_dir)
+
+
+def cmd_validate(args):
+    pattern = re.compile(r'\[gemm\] prec=(\d+) M=(\d+) N=(\d+) K=(\d+) m_tiles=(\d+) '
+                         r'n_tiles=(\d+) k_tiles=(\d+) parallelize=(\d)(\d)(\d) '
+                         r'clusters=(\d+) cycles=(\d+)')
+    runs = []
+    for log in args.logs:
+        for match in pattern.finditer(log.read_text()):
+            prec, M, N, K, mt, nt, kt, pm, pn, pk, num_clusters, measured = \
+                [int(x) for x in match.groups()]
+            tiles = (effective_tiles(M, mt), effective_tiles(N, nt), effective_tiles(K, kt))
+            grid, _ = cluster_grid(*tiles, pm, pn, pk, num_clusters)
+            runs.append(((M, N, K, prec, *tiles, grid, args.cores), num_clusters, measured))
+    if not runs:
+        print('No GEMM runs found in the logs', file=sys.stderr)
+        return 1
+
+    # Least-squares fit of the constants to the measured cycles
+    constants = None
+    if args.fit:
+        terms = [model_terms(*point) for point, _, _ in runs]
+        counts = np.array([c for _, c in terms], dtype=float)
+        residual = np.array([measured - fixed for (fixed, _), (_, _, measured)
+                             in zip(terms, runs)], dtype=float)
+        fit, _, rank, _ = np.linalg.lstsq(counts, residual, rcond=None)
+        constants = [max(0, round(x)) for x in fit]
+        # E.g. on a single cluster, kernels and synchronizations always come
+        # in pairs, so only the sum of their overheads can be calibrated
+        if rank < len(FITTED):
+            print('Warning: the sweep does not separate all constants, e.g. include '
+                  'multi-cluster runs', file=sys.stderr)
+
+    errors = []
+    print(f'{"shape":>14} {"prec":>4} {"clusters":>8} {"tiles":>10} {"measured":>10} '
+          f'{"predicted":>10} {"error":>7}')
+    for point, num_clusters, measured in runs:
+        M, N, K, prec, *tiles = point[:7]
+        predicted = predict_cycles(*point, constants=constants)
+        error = (predicted - measured) / measured
+        errors.append(abs(error))
+        print(f'{f"{M}x{N}x{K}":>14} {prec:>4} {num_clusters:>8} '
+              f'{"x".join(map(str, tiles)):>10} {measured:>10} {predicted:>10} '
+              f'{100 * error:>6.1f}%')
+    print(f'Mean absolute error: {100 * sum(errors) / len(errors):.1f}% '
+          f'over {len(errors)} runs')
+    if constants is not None:
+        print('Fitted constants, to be updated in planner.py and gemm.h:')
+        for name, value in zip(FITTED, constants):
+            print(f'{name} = {value}')
+    return 0
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--cores', type=int, default=8,
+                        help='Number of compute cores per cluster')
+    subparsers = parser.add_subparsers(dest='command', required=True)
+
+    plan_parser = subparsers.add_parser('plan', help='Plan GEMMs on a set of shapes')
+    plan_parser.add_argument('--shapes', nargs='+', required=True,
+                             help='Problem shapes in MxNxK format')
+    plan_parser.add_argument('--prec', type=int, default=8, choices=[1, 2, 4, 8],
+                             help='Size of an element in bytes')
+    plan_parser.add_argument('--clusters', nargs='+', type=int, default=[1],
+                             help='Numbers of clusters to plan for')
+    plan_parser.add_argument('--tcdm-size', type=int, default=du.TCDM_HEAP_SIZE,
+                             help='TCDM space available to the GEMM, in bytes')
+    plan_parser.add_argument('--no-transb', action='store_true',
+                             help='B is not stored in transposed form')
+    plan_parser.add_argument('--epilogue', choices=['none', 'row', 'col'],
+                             help='Plan for an epilogue with the given type of bias')
+    plan_parser.add_argument('--cfg-dir', type=pathlib.Path,
+                             help='If specified, emit a configuration file for every plan')
+    plan_parser.set_defaults(func=cmd_plan)
+
+    sweep_parser = subparsers.add_parser('sweep', help='Plan GEMMs on a sweep specification')
+    sweep_parser.add_argument('spec', type=pathlib.Path,
+                              help='Sweep specification, see data/sweep.json')
+    sweep_parser.add_argument('--cfg-dir', type=pathlib.Path, required=True,
+                              help='Directory to emit a configuration file for every plan to')
+    sweep_parser.set_defaults(func=cmd_sweep)
+
+    validate_parser = subparsers.add_parser('validate',
+                                            help='Compare the model to measured cycles')
+    validate_parser.add_argument('logs', nargs='+', type=pathlib.Path,
+                                 help='Simulation logs of the GEMM application')
+    validate_parser.add_argument('--fit', action='store_true',
+                                 help='Calibrate the model constants on the measured cycles')
+    validate_parser.set_defaults(func=cmd_validate)
+
+    return parser.parse_args()
+
+
+def main():
+    args = parse_args()
+    return args.func(args)
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,125 @@
+#!/usr/bin/env python3
+# Copyright 2024 ETH Zurich and University of Bologna.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+"""Report the cluster grid and utilization of the multi-cluster GEMM.
+
+Mirrors the partitioning in `gemm.h` (see `gemm_cluster_grid()`), to evaluate
+how well a tiling maps to a given number of clusters, in particular for
+non-square problems and problems which don't divide evenly into tiles.
+Optionally emits a GEMM configuration file for every point in the sweep.
+"""
+
+import argparse
+import itertools
+import json
+from math import ceil
+import pathlib
+
+
+def ceil_div(a, b):
+    return (a + b - 1) // b
+
+
+def cluster_grid(m_tiles, n_tiles, k_tiles, parallelize_m, parallelize_n, parallelize_k,
+                 num_clusters):
+    best = (1, 1, 1)
+    best_cost = m_tiles * n_tiles * k_tiles
+    max_m = min(m_tiles, num_clusters) if parallelize_m else 1
+    max_n = min(n_tiles, num_clusters) if parallelize_n else 1
+    max_k = min(k_tiles, num_clusters) if parallelize_k else 1
+    for gk in range(1, max_k + 1):
+        for gm in range(max_m, 0, -1):
+            for gn in range(1, max_n + 1):
+                if gm * gn * gk > num_clusters:
+                    break
+                cost = ceil_div(m_tiles, gm) * ceil_div(n_tiles, gn) * ceil_div(k_tiles, gk)
+                if cost < best_cost:
+                    best_cost = cost
+                    best = (gm, gn, gk)
+    return best, best_cost
+
+
+def evaluate(M, N, K, m_tiles, n_tiles, k_tiles, parallelize_m, parallelize_n,
+             parallelize_k, num_clusters):
+    # Effective number of tiles, after rounding up the tile sizes
+    frac_m, frac_n, frac_k = ceil(M / m_tiles), ceil(N / n_tiles), ceil(K / k_tiles)
+    m_tiles, n_tiles, k_tiles = ceil_div(M, frac_m), ceil_div(N, frac_n), ceil_div(K, frac_k)
+    grid, cost = cluster_grid(m_tiles, n_tiles, k_tiles, parallelize_m, parallelize_n,
+                              parallelize_k, num_clusters)
+    # Utilization is the ratio between the useful work and the work the
+    # clusters could perform in the time taken by the critical path, where
+    # the critical path is approximated by a sequence of full tiles
+    work = M * N * K
+    capacity = num_clusters * cost * frac_m * frac_n * frac_k
+    return {
+        'tiles': (m_tiles, n_tiles, k_tiles),
+        'tile_size': (frac_m, frac_n, frac_k),
+        'grid': grid,
+        'active': grid[0] * grid[1] * grid[2],
+        'utilization': work / capacity,
+    }
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--shapes', nargs='+', default=['64x64x64', '16x256x64', '256x16x64',
+                                                        '24x40x56', '100x36x64'],
+                        help='Problem shapes in MxNxK format')
+    parser.add_argument('--clusters', nargs='+', type=int, default=[1, 2, 4, 8],
+                        help='Numbers of clusters to evaluate')
+    parser.add_argument('--tile-size', nargs=3, type=int, default=[16, 16, 32],
+                        metavar=('TM', 'TN', 'TK'),
+                        help='Maximum tile size in every dimension')
+    parser.add_argument('--no-split-k', action='store_true',
+                        help='Disable parallelization along the K dimension')
+    parser.add_argument('--gemm-fp', default='gemm_fp64_opt',
+                        help='Kernel to use in the emitted configurations')
+    parser.add_argument('--cfg-dir', type=pathlib.Path,
+                        help='If specified, emit a configuration file for every sweep point')
+    return parser.parse_args()
+
+
+def main():
+    args = parse_args()
+    tm, tn, tk = args.tile_size
+    print(f'{"shape":>12} {"clusters":>8} {"tiles":>10} {"tile size":>10} {"grid":>8} '
+          f'{"active":>6} {"util":>6}')
+    for shape, num_clusters in itertools.product(args.shapes, args.clusters):
+        M, N, K = [int(x) for x in shape.split('x')]
+        tiles = (ceil_div(M, tm), ceil_div(N, tn), ceil_div(K, tk))
+        res = evaluate(M, N, K, *tiles, 1, 1, not args.no_split_k, num_clusters)
+        print(f'{shape:>12} {num_clusters:>8} {"x".join(map(str, res["tiles"])):>10} '
+              f'{"x".join(map(str, res["tile_size"])):>10} '
+              f'{"x".join(map(str, res["grid"])):>8} {res["active"]:>6} '
+              f'{res["utilization"]:>6.2f}')
+
+        if args.cfg_dir:
+            cfg = {
+                'setup_ssr': 1,
+                'parallelize_m': 1,
+                'parallelize_n': 1,
+                'parallelize_k': int(not args.no_split_k),
+                'm_tiles': tiles[0],
+                'n_tiles': tiles[1],
+                'k_tiles': tiles[2],
+                'load_a': 1,
+                'load_b': 1,
+                'load_c': 1,
+                'transa': False,
+                'transb': True,
+                'M': M,
+                'N': N,
+                'K': K,
+                'alpha': 1,
+                'beta': 0,
+                'gemm_fp': args.gemm_fp,
+            }
+            args.cfg_dir.mkdir(parents=True, exist_ok=True)
+            with open(args.cfg_dir / f'{shape}-{num_clusters}.json', 'w') as f:
+                json.dump(cfg, f, indent=4)
+
+
+if __name__ == '__main__':
+    main()
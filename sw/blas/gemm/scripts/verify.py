@@ -20,7 +20,10 @@ class GemmVerifier(Verifier):
         1: 1e-4,
         2: 5e-1,
         4: 1e-3,
-        8: 1e-3
+        8: 1e-3,
+        0x11: 0,
+        0x12: 0,
+        0x14: 0
     }
 
     def __init__(self):
@@ -30,6 +33,7 @@ class GemmVerifier(Verifier):
             'prec': 'I',
             'setup_ssr': 'I',
             'parallelize_m': 'I',
+            'parallelize_n': 'I',
             'parallelize_k': 'I',
             'm_tiles': 'I',
             'n_tiles': 'I',
@@ -46,19 +50,46 @@ class GemmVerifier(Verifier):
             'b': 'I',
             'beta': 'I',
             'c': 'I',
-            'gemm_fp': 'I'
+            'gemm_fp': 'I',
+            'epilogue': 'I'
         }
         self.func_args = self.get_input_from_symbol('args', self.func_args)
+        # With an epilogue, the result is written to the separate `out` array
+        self.epi = None
+        if self.func_args['epilogue']:
+            self.epi = self.get_input_from_symbol('epi', {
+                'beta': 'd',
+                'bias': 'I',
+                'act': 'I',
+                'bias_ptr': 'I',
+                'out_prec': 'I',
+                'out': 'I',
+                'padding': '4x'
+            })
+            self.OUTPUT_UIDS = ['out']
 
-    def get_actual_results(self):
+    def prec_c(self):
+        # Integer GEMMs produce an INT32 C matrix
         prec = self.func_args['prec']
-        return self.get_output_from_symbol(self.OUTPUT_UIDS[0], ctype_from_precision_t(prec))
+        return 0x14 if prec & 0x10 else prec
+
+    def ctype_c(self):
+        return ctype_from_precision_t(self.prec_c())
+
+    def out_prec(self):
+        if self.epi and self.epi['out_prec']:
+            return self.epi['out_prec']
+        return self.prec_c()
+
+    def get_actual_results(self):
+        return self.get_output_from_symbol(self.OUTPUT_UIDS[0],
+                                           ctype_from_precision_t(self.out_prec()))
 
     def get_expected_results(self):
         prec = self.func_args['prec']
         a = self.get_input_from_symbol('a', ctype_from_precision_t(prec))
         b = self.get_input_from_symbol('b', ctype_from_precision_t(prec))
-        c = self.get_input_from_symbol('c', ctype_from_precision_t(prec))
+        c = self.get_input_from_symbol('c', self.ctype_c())
         beta = self.func_args['beta']
         m = self.func_args['M']
         n = self.func_args['N']
@@ -72,10 +103,18 @@ class GemmVerifier(Verifier):
         else:
             b = np.reshape(b, (k, n))
         c = np.reshape(c, (m, n))
-        return GemmDataGen().exact_golden_model(1, a, b, beta, c).flatten()
+        alpha = self.func_args['alpha']
+        if self.epi:
+            bias = None
+            if self.epi['bias']:
+                bias = self.get_input_from_symbol('bias', self.ctype_c())
+            return GemmDataGen().epilogue_golden_model(
+                alpha, a, b, self.epi['beta'], c, self.epi['bias'], bias, self.epi['act'],
+                self.out_prec()).flatten()
+        return GemmDataGen().exact_golden_model(alpha, a, b, beta, c).flatten()
 
     def check_results(self, *args):
-        prec = self.func_args['prec']
+        prec = self.out_prec() if self.epi else self.func_args['prec']
         return super().check_results(*args, rtol=self.ERR_THRESHOLD[prec])
 
 
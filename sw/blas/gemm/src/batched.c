@@ -0,0 +1,62 @@
+// Copyright 2024 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+//
+// Benchmark of the batched GEMM. The M x N x K problem in the data file is
+// split into a batch of BATCH_M x N x K problems, sharing the B matrix. The
+// batch is computed once calling gemm() on every item, and once with a
+// single call to gemm_batched(), and the cycles of both are reported. The
+// results must match exactly, as both use the same kernel.
+
+#include <stdint.h>
+
+#include "blas.h"
+
+#include "data.h"
+#include "snrt.h"
+
+#define BATCH_M 4
+
+static __typeof__(c) c_batched;
+
+int main() {
+    uint32_t batch_count = args.M / BATCH_M;
+    uint32_t stride_a = BATCH_M * args.K;
+    uint32_t stride_c = BATCH_M * args.N;
+
+    gemm_args_t item_args = args;
+    item_args.M = BATCH_M;
+    item_args.m_tiles = 1;
+    item_args.n_tiles = 1;
+    item_args.k_tiles = 1;
+
+    // One gemm() call per batch item
+    snrt_global_barrier();
+    uint32_t start_cycle = snrt_mcycle();
+    for (uint32_t i = 0; i < batch_count; i++) {
+        item_args.a = (void *)a + i * stride_a * args.prec;
+        item_args.c = (void *)c + i * stride_c * args.prec;
+        gemm(&item_args);
+        snrt_cluster_hw_barrier();
+    }
+    snrt_global_barrier();
+    uint32_t loop_cycles = snrt_mcycle() - start_cycle;
+
+    // Single gemm_batched() call
+    item_args.a = a;
+    item_args.c = c_batched;
+    start_cycle = snrt_mcycle();
+    int retcode = gemm_batched(&item_args, batch_count, stride_a, 0, stride_c);
+    snrt_global_barrier();
+    uint32_t batched_cycles = snrt_mcycle() - start_cycle;
+
+    uint32_t errors = retcode != 0;
+    if (snrt_global_core_idx() == 0) {
+        printf("[gemm_batched] batch=%u M=%u N=%u K=%u loop=%u batched=%u\n",
+               batch_count, BATCH_M, args.N, args.K, loop_cycles,
+               batched_cycles);
+        for (uint32_t i = 0; i < sizeof(c) / sizeof(c[0]); i++)
+            errors += c_batched[i] != c[i];
+    }
+    return errors;
+}
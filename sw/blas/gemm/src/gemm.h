@@ -17,6 +17,8 @@
 #include "gemm_fp32.h"
 #include "gemm_fp64.h"
 #include "gemm_fp8.h"
+#include "gemm_i16.h"
+#include "gemm_i8.h"
 
 // define the gemm_fp function pointer
 typedef void (*gemm_fp_t)(uint32_t m, uint32_t n, uint32_t k, void* a,
@@ -29,6 +31,7 @@ typedef struct {
     uint32_t prec;
     uint32_t setup_ssr;
     uint32_t parallelize_m;
+    uint32_t parallelize_n;
     uint32_t parallelize_k;
     uint32_t m_tiles;
     uint32_t n_tiles;
@@ -46,27 +49,109 @@ typedef struct {
     uint32_t beta;
     void* c;
     void* gemm_fp;
+    void* epilogue;
 } gemm_args_t;
 
-// BLAS compliant single-cluster single-tile GEMM kernel, with some additional
-// arguments at the beginning to specify Snitch implementation details. Matrix
-// sizes and pointers are for the whole cluster computation. Within a cluster
-// the computation is parallelized by assigning distinct output rows to
-// distinct cores.
+// Bias added by the GEMM epilogue. A row bias holds one value per row of C
+// (M elements), a column bias one value per column (N elements), as in the
+// bias of a linear layer.
+typedef enum { GEMM_BIAS_NONE, GEMM_BIAS_ROW, GEMM_BIAS_COL } gemm_bias_t;
+
+// Activation applied by the GEMM epilogue
+typedef enum { GEMM_ACT_NONE, GEMM_ACT_RELU, GEMM_ACT_GELU } gemm_act_t;
+
+// Operations fused by gemm() into the store of every output tile, computing
+// out = act(alpha * A * B + beta * C + bias) in the out_prec precision.
+// The bias is stored in the precision of C. An out_prec of zero keeps the
+// precision of C, and a NULL out overwrites C, densely packed in out_prec.
+// The epilogue is only supported for FP64, FP32 and INT32 C matrices.
+// Conversions to integer precisions round to the nearest integer and
+// saturate, e.g. to requantize the INT32 result of an INT8 GEMM to INT8.
+typedef struct {
+    double beta;
+    uint32_t bias;
+    uint32_t act;
+    void* bias_ptr;
+    uint32_t out_prec;
+    void* out;
+} gemm_epilogue_t;
+
+// Extent of the cluster grid in every dimension of the iteration space
+typedef struct {
+    uint32_t m;
+    uint32_t n;
+    uint32_t k;
+} gemm_grid_t;
+
+static inline uint32_t gemm_ceil_div(uint32_t a, uint32_t b) {
+    return (a + b - 1) / b;
+}
+
+// Size in bytes of an element of the given precision
+static inline uint32_t gemm_prec_size(precision_t prec) { return prec & 0xf; }
+
+// Precision of the C matrix. Integer GEMMs accumulate in 32-bit integers.
+static inline precision_t gemm_prec_c(precision_t prec) {
+    return prec & 0x10 ? INT32 : prec;
+}
+
+// Choose how to lay out `num_clusters` clusters as a grid over the M, N and K
+// tiles, in the dimensions in which parallelization is enabled. The grid
+// minimizes the number of tiles on the critical path, i.e. the tiles computed
+// by the most loaded cluster. Among equivalent grids, fewer clusters along K
+// are preferred, as split-K requires a reduction, and then more clusters
+// along M. The grid may leave clusters idle if this does not shorten the
+// critical path.
+static inline gemm_grid_t gemm_cluster_grid(uint32_t m_tiles, uint32_t n_tiles,
+                                            uint32_t k_tiles,
+                                            uint32_t parallelize_m,
+                                            uint32_t parallelize_n,
+                                            uint32_t parallelize_k,
+                                            uint32_t num_clusters) {
+    gemm_grid_t best = {1, 1, 1};
+    uint32_t best_cost = m_tiles * n_tiles * k_tiles;
+    uint32_t max_m = parallelize_m ? m_tiles : 1;
+    uint32_t max_n = parallelize_n ? n_tiles : 1;
+    uint32_t max_k = parallelize_k ? k_tiles : 1;
+    if (max_m > num_clusters) max_m = num_clusters;
+    if (max_n > num_clusters) max_n = num_clusters;
+    if (max_k > num_clusters) max_k = num_clusters;
+
+    for (uint32_t gk = 1; gk <= max_k; gk++) {
+        for (uint32_t gm = max_m; gm >= 1; gm--) {
+            for (uint32_t gn = 1; gn <= max_n; gn++) {
+                if (gm * gn * gk > num_clusters) break;
+                uint32_t cost = gemm_ceil_div(m_tiles, gm) *
+                                gemm_ceil_div(n_tiles, gn) *
+                                gemm_ceil_div(k_tiles, gk);
+                if (cost < best_cost) {
+                    best_cost = cost;
+                    best = (gemm_grid_t){gm, gn, gk};
+                }
+            }
+        }
+    }
+    return best;
+}
+
+// Single-cluster GEMM kernel on an explicitly-sized tile, with some
+// additional arguments at the beginning to specify Snitch implementation
+// details. Matrix sizes and pointers are for the whole cluster computation.
+// The operands are stored densely, i.e. with leading dimensions equal to the
+// tile sizes. Within a cluster the computation is parallelized by assigning
+// distinct output rows to distinct cores.
 // TODO: beta (and alpha) should be of floating-point type (same precision as
 // operands)
-void sc_st_gemm(gemm_args_t* gemm_args, void* a, void* b, uint32_t beta,
-                void* c) {
+void sc_st_gemm_tile(gemm_args_t* gemm_args, uint32_t m, uint32_t n,
+                     uint32_t k, void* a, void* b, uint32_t beta, void* c,
+                     uint32_t setup_ssr) {
     gemm_fp_t impl = (gemm_fp_t)gemm_args->gemm_fp;
     precision_t prec = gemm_args->prec;
-    uint32_t setup_ssr = gemm_args->setup_ssr;
+    uint32_t size_ab = gemm_prec_size(prec);
+    uint32_t size_c = gemm_prec_size(gemm_prec_c(prec));
     uint32_t transa = gemm_args->transa;
     uint32_t transb = gemm_args->transb;
 
-    uint32_t m = gemm_args->M / gemm_args->m_tiles;
-    uint32_t n = gemm_args->N / gemm_args->n_tiles;
-    uint32_t k = gemm_args->K / gemm_args->k_tiles;
-
     uint32_t lda = k;
     uint32_t ldb;
     if (transb) {
@@ -87,8 +172,8 @@ void sc_st_gemm(gemm_args_t* gemm_args, void* a, void* b, uint32_t beta,
         uint32_t ldc_strided = compute_num * ldc;
 
         // Compute cores access A and C at offsets of one row from each other
-        uint32_t offsetA = compute_id * lda * prec;
-        uint32_t offsetC = compute_id * ldc * prec;
+        uint32_t offsetA = compute_id * lda * size_ab;
+        uint32_t offsetC = compute_id * ldc * size_c;
 
         // Compute fraction of C rows every core computes
         uint32_t frac_m = m / compute_num;
@@ -101,23 +186,149 @@ void sc_st_gemm(gemm_args_t* gemm_args, void* a, void* b, uint32_t beta,
     }
 }
 
+// BLAS compliant single-cluster single-tile GEMM kernel, operating on tiles
+// of size M / m_tiles x N / n_tiles x K / k_tiles.
+void sc_st_gemm(gemm_args_t* gemm_args, void* a, void* b, uint32_t beta,
+                void* c) {
+    sc_st_gemm_tile(gemm_args, gemm_args->M / gemm_args->m_tiles,
+                    gemm_args->N / gemm_args->n_tiles,
+                    gemm_args->K / gemm_args->k_tiles, a, b, beta, c,
+                    gemm_args->setup_ssr);
+}
+
+// Sigmoid based approximation of the GeLU activation function, adapted from
+// i-BERT (https://arxiv.org/pdf/2101.01321.pdf)
+static inline double gemm_gelu(double x) {
+    const double a = -0.2888, b = -1.769;
+    double sign = x > 0.0 ? 1.0 : -1.0;
+    double x_scaled = x * 0.7071067811865476;
+    double arg = x_scaled > 0.0 ? x_scaled : -x_scaled;
+    if (arg > -b) arg = -b;
+    double l = sign * (a * (arg + b) * (arg + b) + 1.0);
+    return x * 0.5 * (1.0 + l);
+}
+
+static inline double gemm_epilogue_load(void* c, uint32_t i,
+                                        precision_t prec) {
+    if (prec == FP64)
+        return ((double*)c)[i];
+    else if (prec == FP32)
+        return ((float*)c)[i];
+    else
+        return ((int32_t*)c)[i];
+}
+
+// Round to the nearest integer, away from zero on ties, and saturate to the
+// range [min, max]
+static inline int32_t gemm_round_sat(double x, int32_t min, int32_t max) {
+    if (x <= min) return min;
+    if (x >= max) return max;
+    return x >= 0.0 ? (int32_t)(x + 0.5) : (int32_t)(x - 0.5);
+}
+
+static inline void gemm_epilogue_store(void* c, uint32_t i, double x,
+                                       precision_t prec) {
+    switch (prec) {
+        case FP64:
+            ((double*)c)[i] = x;
+            break;
+        case FP32:
+            ((float*)c)[i] = (float)x;
+            break;
+        case FP16:
+            ((__fp16*)c)[i] = (__fp16)(float)x;
+            break;
+        case INT32:
+            ((int32_t*)c)[i] = gemm_round_sat(x, INT32_MIN, INT32_MAX);
+            break;
+        case INT16:
+            ((int16_t*)c)[i] = gemm_round_sat(x, INT16_MIN, INT16_MAX);
+            break;
+        case INT8:
+            ((int8_t*)c)[i] = gemm_round_sat(x, INT8_MIN, INT8_MAX);
+            break;
+        case FP8: {
+            float x_fp32 = (float)x;
+            asm volatile(
+                "fcvt.b.s ft3, %[x]\n"
+                "fsb ft3, 0(%[dst])\n"
+                :
+                : [ x ] "f"(x_fp32), [ dst ] "r"((char*)c + i)
+                : "ft3", "memory");
+            break;
+        }
+    }
+}
+
+// Apply an epilogue to an m x n tile of C, with the bias slice of the tile.
+// Every element is scaled by alpha, biased and passed through the
+// activation, and every row is converted to out_prec, packing it at the
+// beginning of the row, ready to be stored with a 2D transfer. With a NULL
+// epilogue the tile is only scaled by alpha. The rows are distributed to the
+// compute cores as in sc_st_gemm_tile().
+static inline void gemm_epilogue_apply(gemm_epilogue_t* epi, double alpha,
+                                       precision_t prec, precision_t out_prec,
+                                       uint32_t m, uint32_t n, void* c,
+                                       void* bias) {
+    if (!snrt_is_compute_core()) return;
+
+    uint32_t bias_type = epi ? epi->bias : GEMM_BIAS_NONE;
+    uint32_t act = epi ? epi->act : GEMM_ACT_NONE;
+    for (uint32_t i = snrt_cluster_core_idx(); i < m;
+         i += snrt_cluster_compute_core_num()) {
+        void* row = c + i * n * gemm_prec_size(prec);
+        for (uint32_t j = 0; j < n; j++) {
+            double x = alpha * gemm_epilogue_load(row, j, prec);
+            if (bias_type == GEMM_BIAS_ROW)
+                x += gemm_epilogue_load(bias, i, prec);
+            else if (bias_type == GEMM_BIAS_COL)
+                x += gemm_epilogue_load(bias, j, prec);
+            if (act == GEMM_ACT_RELU)
+                x = x > 0.0 ? x : 0.0;
+            else if (act == GEMM_ACT_GELU)
+                x = gemm_gelu(x);
+            gemm_epilogue_store(row, j, x, out_prec);
+        }
+    }
+    snrt_fpu_fence();
+}
+
 // Multiple-cluster multiple-tile GEMM implementation.
-// If parallelize_m, assigns a distinct subset of M-tiles to distinct clusters.
-// If parallelize_k, then K-tiles are distributed to distinct clusters; a
-// binary reduction tree is implemented to accumulate these tiles together.
-// Note: in the current implementation, parallelize_m and parallelize_k
-// should be mutually-exclusive. The load_* options allow to bypass the DMA
-// transfers and operate directly on the a, b and c inputs.
-// m_tiles: number of tiles in M dimension
-// k_tiles: number of tiles in K dimension
-// n_tiles: number of tiles in N dimension
+// The M, N and K dimensions are split in m_tiles, n_tiles and k_tiles tiles
+// respectively. Tiles have size ceil(M / m_tiles) etc., except for the last
+// tile in every dimension which covers the remainder, so the dimensions need
+// not be multiples of the tile counts.
+// The clusters are arranged as a grid over the tiles (see gemm_cluster_grid),
+// along the dimensions for which parallelize_m, parallelize_n and
+// parallelize_k are set. Each cluster iterates over a contiguous block of
+// M-tiles and N-tiles, and accumulates a contiguous block of K-tiles. If the
+// K-tiles are split across clusters, the partial results of the clusters
+// sharing an output tile are accumulated together with a binary reduction
+// tree.
+// The load_* options allow to bypass the DMA transfers and operate directly
+// on the a, b and c inputs.
+// Alpha is applied to every output tile before it is stored, together with
+// the optional epilogue (see gemm_epilogue_t). To this end, C is prescaled
+// by beta / alpha, so alpha must be non-zero, and beta must be zero or equal
+// to alpha for integer GEMMs. Conversion to a lower output precision
+// requires load_c.
+// Integer GEMMs take INT8 or INT16 operands and produce an INT32 C matrix.
+// They are not parallelized along K, as the reduction only supports
+// floating-point precisions.
 int gemm(gemm_args_t* args) {
     gemm_args_t* local_args = snrt_l1_next();
+    gemm_epilogue_t* local_epi =
+        (void*)local_args + ALIGN_UP(sizeof(gemm_args_t), 8);
 
-    // Copy the arguments to local memory
+    // Copy the arguments, and the epilogue if any, to local memory
     if (snrt_is_dm_core()) {
         snrt_dma_start_1d(local_args, args, sizeof(gemm_args_t));
         snrt_dma_wait_all();
+        if (local_args->epilogue) {
+            snrt_dma_start_1d(local_epi, local_args->epilogue,
+                              sizeof(gemm_epilogue_t));
+            snrt_dma_wait_all();
+        }
     }
     snrt_cluster_hw_barrier();
 
@@ -126,102 +337,166 @@ int gemm(gemm_args_t* args) {
     uint32_t k = local_args->K;
     precision_t prec = (precision_t)local_args->prec;
     uint32_t setup_ssr = local_args->setup_ssr;
-    uint32_t parallelize_m = local_args->parallelize_m;
-    uint32_t parallelize_k = local_args->parallelize_k;
-    uint32_t m_tiles = local_args->m_tiles;
-    uint32_t n_tiles = local_args->n_tiles;
-    uint32_t k_tiles = local_args->k_tiles;
     uint32_t load_a = local_args->load_a;
     uint32_t load_b = local_args->load_b;
     uint32_t load_c = local_args->load_c;
-    uint32_t transa = local_args->transa;
     uint32_t transb = local_args->transb;
-    double alpha = local_args->alpha;
     void* a = local_args->a;
     void* b = local_args->b;
-    uint32_t beta = local_args->beta;
     void* c = local_args->c;
+    gemm_epilogue_t* epi = local_args->epilogue ? local_epi : NULL;
+
+    // The kernels only accumulate on C or overwrite it. A generic beta is
+    // applied by prescaling C in the first K iteration by beta / alpha, and
+    // alpha by the epilogue.
+    double alpha = local_args->alpha;
+    double beta_fp = epi ? epi->beta : (double)local_args->beta;
+    uint32_t beta = beta_fp != 0;
+    uint32_t scale_c = beta && beta_fp != alpha;
+    uint32_t apply_epilogue = epi || alpha != 1;
+    precision_t prec_c = gemm_prec_c(prec);
+    precision_t out_prec = epi && epi->out_prec ? epi->out_prec : prec_c;
+    uint32_t size_ab = gemm_prec_size(prec);
+    uint32_t size_c = gemm_prec_size(prec_c);
+    uint32_t size_out = gemm_prec_size(out_prec);
+    void* out = epi && epi->out ? epi->out : c;
+    uint32_t bias = epi ? epi->bias : GEMM_BIAS_NONE;
+    if (apply_epilogue || scale_c) {
+        if (prec_c != FP64 && prec_c != FP32 && prec_c != INT32) return -1;
+        if (alpha == 0 || (scale_c && prec_c == INT32)) return -1;
+        if (size_out > size_c || (out_prec != prec_c && !load_c)) return -1;
+    }
 
-    // Calculate tile sizes
-    uint32_t frac_m = m / m_tiles;
-    uint32_t frac_n = n / n_tiles;
-    uint32_t frac_k = k / k_tiles;
-    uint32_t frac_a = frac_m * frac_k;
-    uint32_t frac_c = frac_m * frac_n;
-    uint32_t size_frac_a = frac_a * prec;
-    uint32_t size_frac_b = frac_k * frac_n * prec;
-    uint32_t size_frac_c = frac_c * prec;
-
-    // Allocate space in TCDM
-    void *local_a, *local_b, *local_c_partial, *local_c;
-    void* heap_ptr = (void*)local_args + sizeof(gemm_args_t);
+    // Calculate tile sizes, and the number of non-empty tiles
+    uint32_t frac_m = gemm_ceil_div(m, local_args->m_tiles);
+    uint32_t frac_n = gemm_ceil_div(n, local_args->n_tiles);
+    uint32_t frac_k = gemm_ceil_div(k, local_args->k_tiles);
+    uint32_t m_tiles = gemm_ceil_div(m, frac_m);
+    uint32_t n_tiles = gemm_ceil_div(n, frac_n);
+    uint32_t k_tiles = gemm_ceil_div(k, frac_k);
+    uint32_t size_frac_a = frac_m * frac_k * size_ab;
+    uint32_t size_frac_b = frac_k * frac_n * size_ab;
+    uint32_t size_frac_c = frac_m * frac_n * size_c;
+
+    // Position of the cluster in the cluster grid
+    gemm_grid_t grid = gemm_cluster_grid(
+        m_tiles, n_tiles, k_tiles, local_args->parallelize_m,
+        local_args->parallelize_n,
+        local_args->parallelize_k && prec_c != INT32, snrt_cluster_num());
+    uint32_t grid_mn = grid.m * grid.n;
+    uint32_t cluster_idx = snrt_cluster_idx();
+    uint32_t grid_k_idx = cluster_idx / grid_mn;
+    uint32_t grid_m_idx = (cluster_idx % grid_mn) / grid.n;
+    uint32_t grid_n_idx = cluster_idx % grid.n;
+    if (grid_k_idx >= grid.k) return 0;
+
+    // Allocate space in TCDM. Buffers are 8-byte aligned, and lie at the same
+    // offset in all clusters, as required by the reduction.
+    void *local_a, *local_b, *local_c_partial, *local_c, *local_bias;
+    void* heap_ptr = local_epi;
+    if (epi) heap_ptr += ALIGN_UP(sizeof(gemm_epilogue_t), 8);
     if (load_a) {
         local_a = heap_ptr;
-        heap_ptr += size_frac_a;
+        heap_ptr += ALIGN_UP(size_frac_a, 8);
     } else
         local_a = a;
     if (load_b) {
         local_b = heap_ptr;
-        heap_ptr += size_frac_b;
+        heap_ptr += ALIGN_UP(size_frac_b, 8);
     } else
         local_b = b;
     if (load_c) {
         local_c_partial = heap_ptr;
-        heap_ptr += size_frac_c;
+        heap_ptr += ALIGN_UP(size_frac_c, 8);
     } else
         local_c_partial = c;
-    local_c = parallelize_k ? heap_ptr : local_c_partial;
-
-    // Assign m and k tiles to clusters
-    uint32_t m_tiles_per_cluster =
-        parallelize_m ? m_tiles / snrt_cluster_num() : m_tiles;
-    uint32_t k_tiles_per_cluster =
-        parallelize_k ? k_tiles / snrt_cluster_num() : k_tiles;
-
-    // Every cluster iterates over its subset of m tiles
-    for (uint32_t m_tile = 0; m_tile < m_tiles_per_cluster; m_tile++) {
-        for (uint32_t n_tile = 0; n_tile < n_tiles; n_tile++) {
-            // Calculate absolute m tile index for the current cluster
-            uint32_t abs_m_tile_idx =
-                !parallelize_m
-                    ? m_tile
-                    : snrt_cluster_idx() * m_tiles_per_cluster + m_tile;
+    local_c = grid.k > 1 ? heap_ptr : local_c_partial;
+    if (grid.k > 1) heap_ptr += ALIGN_UP(size_frac_c, 8);
+    if (bias != GEMM_BIAS_NONE) {
+        local_bias = heap_ptr;
+        heap_ptr +=
+            ALIGN_UP((bias == GEMM_BIAS_ROW ? frac_m : frac_n) * size_c, 8);
+    }
+
+    // Fail if the buffers overflow the TCDM, e.g. because of too large
+    // tiles, see gemm_plan()
+    if ((uint32_t)heap_ptr > snrt_l1_allocator()->end) return -1;
+
+    // Every cluster is assigned a contiguous block of tiles in each dimension
+    uint32_t m_tile_start = grid_m_idx * m_tiles / grid.m;
+    uint32_t m_tile_end = (grid_m_idx + 1) * m_tiles / grid.m;
+    uint32_t n_tile_start = grid_n_idx * n_tiles / grid.n;
+    uint32_t n_tile_end = (grid_n_idx + 1) * n_tiles / grid.n;
+    uint32_t k_tile_start = grid_k_idx * k_tiles / grid.k;
+    uint32_t k_tile_end = (grid_k_idx + 1) * k_tiles / grid.k;
+
+    // SSRs need to be reconfigured whenever the tile size changes
+    uint32_t prev_m = 0, prev_n = 0, prev_k = 0;
+
+    for (uint32_t m_tile = m_tile_start; m_tile < m_tile_end; m_tile++) {
+        uint32_t m0 = m_tile * frac_m;
+        uint32_t tile_m = m - m0 < frac_m ? m - m0 : frac_m;
+
+        for (uint32_t n_tile = n_tile_start; n_tile < n_tile_end; n_tile++) {
+            uint32_t n0 = n_tile * frac_n;
+            uint32_t tile_n = n - n0 < frac_n ? n - n0 : frac_n;
 
             // k accumulation loop
-            for (uint32_t k_tile = 0; k_tile < k_tiles_per_cluster; k_tile++) {
-                // Calculate absolute k tile index for the current cluster
-                uint32_t abs_k_tile_idx =
-                    !parallelize_k
-                        ? k_tile
-                        : snrt_cluster_idx() * k_tiles_per_cluster + k_tile;
+            for (uint32_t k_tile = k_tile_start; k_tile < k_tile_end;
+                 k_tile++) {
+                uint32_t k0 = k_tile * frac_k;
+                uint32_t tile_k = k - k0 < frac_k ? k - k0 : frac_k;
 
                 // Copy data in TCDM
                 if (snrt_is_dm_core()) {
                     if (load_a) {
-                        snrt_dma_load_2d_tile(local_a, a, abs_m_tile_idx,
-                                              abs_k_tile_idx, frac_m, frac_k, k,
-                                              prec);
+                        snrt_dma_start_2d(
+                            local_a, a + (m0 * k + k0) * size_ab,
+                            tile_k * size_ab, tile_k * size_ab, k * size_ab,
+                            tile_m);
                     }
                     if (load_b) {
-                        snrt_dma_load_2d_tile(local_b, b, abs_k_tile_idx,
-                                              n_tile, frac_k, frac_n, n, prec);
+                        if (transb)
+                            snrt_dma_start_2d(
+                                local_b, b + (n0 * k + k0) * size_ab,
+                                tile_k * size_ab, tile_k * size_ab,
+                                k * size_ab, tile_n);
+                        else
+                            snrt_dma_start_2d(
+                                local_b, b + (k0 * n + n0) * size_ab,
+                                tile_n * size_ab, tile_n * size_ab,
+                                n * size_ab, tile_k);
                     }
                     // C tile is loaded only upon first iteration, then the C
                     // array will contain the partial results from the
                     // previous iteration
                     if (load_c) {
-                        if (abs_k_tile_idx == 0) {
-                            snrt_dma_load_2d_tile(local_c_partial, c,
-                                                  abs_m_tile_idx, n_tile,
-                                                  frac_m, frac_n, n, prec);
-                        } else if (k_tile == 0) {
-                            // Clusters other than the first need to initialize
-                            // the C array to zero in their first iteration
-                            snrt_dma_start_1d(local_c_partial,
-                                              (void*)snrt_zero_memory_ptr(),
-                                              frac_m * frac_n * prec);
+                        if (k_tile == 0) {
+                            snrt_dma_start_2d(local_c_partial,
+                                              c + (m0 * n + n0) * size_c,
+                                              tile_n * size_c, tile_n * size_c,
+                                              n * size_c, tile_m);
+                        } else if (k_tile == k_tile_start) {
+                            // Clusters other than the first along K need to
+                            // initialize the C array to zero in their first
+                            // iteration
+                            snrt_memset(local_c_partial, 0,
+                                        tile_m * tile_n * size_c);
                         }
                     }
+                    // The bias slice of the output tile is needed by the
+                    // first cluster along K only
+                    if (bias != GEMM_BIAS_NONE && grid_k_idx == 0 &&
+                        k_tile == k_tile_start) {
+                        if (bias == GEMM_BIAS_ROW)
+                            snrt_dma_start_1d(local_bias,
+                                              epi->bias_ptr + m0 * size_c,
+                                              tile_m * size_c);
+                        else
+                            snrt_dma_start_1d(local_bias,
+                                              epi->bias_ptr + n0 * size_c,
+                                              tile_n * size_c);
+                    }
                     snrt_dma_wait_all();
                 }
 
@@ -229,53 +504,401 @@ int gemm(gemm_args_t* args) {
 
                 // Compute
                 if (!snrt_is_dm_core()) {
-                    uint32_t start_cycle = snrt_mcycle();
-
-                    volatile uint32_t ldb = frac_n;
-                    volatile uint32_t ldc = frac_n;
-
-                    if (transb) {
-                        ldb = frac_k;
-                    }
-
                     // In the first K iteration we accumulate with the C matrix
                     // scaled by beta, in successive iterations we accumulate
                     // the previous partial result for the tile
                     uint32_t beta_k;
-                    if (abs_k_tile_idx == 0) {
+                    if (k_tile == 0) {
                         beta_k = beta;
+                        if (scale_c)
+                            gemm_epilogue_apply(NULL, beta_fp / alpha, prec_c,
+                                                prec_c, tile_m, tile_n,
+                                                local_c_partial, NULL);
                     } else {
                         beta_k = 1;
                     }
 
-                    sc_st_gemm(local_args, local_a, local_b, beta_k,
-                               local_c_partial);
-
-                    uint32_t end_cycle = snrt_mcycle();
+                    uint32_t resized = prev_m && (tile_m != prev_m ||
+                                                  tile_n != prev_n ||
+                                                  tile_k != prev_k);
+                    sc_st_gemm_tile(local_args, tile_m, tile_n, tile_k,
+                                    local_a, local_b, beta_k, local_c_partial,
+                                    setup_ssr || resized);
+                    prev_m = tile_m;
+                    prev_n = tile_n;
+                    prev_k = tile_k;
                 }
 
                 snrt_cluster_hw_barrier();
             }
 
-            // Add the partial results from the various clusters together in a
-            // logarithmic reduction fashion
-            if (parallelize_k) {
-                snrt_global_reduction_dma((double*)local_c,
-                                          (double*)local_c_partial,
-                                          frac_m * frac_n);
+            // Add the partial results from the clusters sharing this output
+            // tile together in a logarithmic reduction fashion
+            if (grid.k > 1) {
+                snrt_group_reduction_dma_generic(
+                    local_c, local_c_partial, tile_m * tile_n, prec,
+                    SNRT_REDUCTION_SUM, grid_mn, grid.k);
             }
 
-            // Copy data out of TCDM
-            if (snrt_is_dm_core()) {
-                // If parallelize_k, then only cluster 0 must writeback
-                if ((snrt_cluster_idx() == 0) || !parallelize_k) {
-                    snrt_dma_store_2d_tile(c, local_c, abs_m_tile_idx, n_tile,
-                                           frac_m, frac_n, n, prec);
-                    snrt_dma_wait_all();
+            // Apply the epilogue while the output tile is still in TCDM
+            if (apply_epilogue && grid_k_idx == 0) {
+                gemm_epilogue_apply(epi, alpha, prec_c, out_prec, tile_m,
+                                    tile_n, local_c, local_bias);
+                snrt_cluster_hw_barrier();
+            }
+
+            // Copy data out of TCDM. If the K-tiles are split, only the first
+            // cluster along K holds the result.
+            if (snrt_is_dm_core() && grid_k_idx == 0 &&
+                (load_c || grid.k > 1 || out != c)) {
+                snrt_dma_start_2d(out + (m0 * n + n0) * size_out, local_c,
+                                  tile_n * size_out, n * size_out,
+                                  tile_n * size_c, tile_m);
+                snrt_dma_wait_all();
+            }
+        }
+    }
+
+    return 0;
+}
+
+// Batched GEMM. Computes batch_count independent GEMMs, all of the shape
+// and with the settings in `args`, where the operands of the i-th GEMM are
+// found at args->a + i * stride_a, args->b + i * stride_b and
+// args->c + i * stride_c. Strides are in elements; a stride of zero shares
+// an operand across the batch.
+// Every GEMM in the batch is computed as a whole, so the tiling and
+// parallelization fields in `args` are ignored, and all operands are staged
+// in TCDM, regardless of the load_* fields. Alpha and the epilogue are not
+// supported. Batch items are processed in groups, distributed round-robin to
+// the clusters. If items have fewer rows than there are compute cores, every
+// core computes a distinct item of the group, otherwise a group consists of a
+// single item whose rows are split across the cores. The DMA transfers of
+// the next group are overlapped with the computation of the current one, and
+// the SSRs are configured only once.
+// Returns 0 on success, -1 if two groups do not fit in TCDM.
+int gemm_batched(gemm_args_t* args, uint32_t batch_count, uint32_t stride_a,
+                 uint32_t stride_b, uint32_t stride_c) {
+    gemm_args_t* local_args = snrt_l1_next();
+
+    // Copy the arguments to local memory
+    if (snrt_is_dm_core()) {
+        snrt_dma_start_1d(local_args, args, sizeof(gemm_args_t));
+        snrt_dma_wait_all();
+    }
+    snrt_cluster_hw_barrier();
+
+    uint32_t m = local_args->M;
+    uint32_t n = local_args->N;
+    uint32_t k = local_args->K;
+    precision_t prec = (precision_t)local_args->prec;
+    uint32_t transa = local_args->transa;
+    uint32_t transb = local_args->transb;
+    uint32_t beta = local_args->beta;
+    void* a = local_args->a;
+    void* b = local_args->b;
+    void* c = local_args->c;
+    gemm_fp_t impl = (gemm_fp_t)local_args->gemm_fp;
+    uint32_t compute_num = snrt_cluster_compute_core_num();
+    uint32_t compute_id = snrt_cluster_core_idx();
+
+    // Allocate two buffers in TCDM, each holding the operands of a group
+    uint32_t group_size = m < compute_num ? compute_num : 1;
+    uint32_t size_ab = gemm_prec_size(prec);
+    uint32_t size_c_elem = gemm_prec_size(gemm_prec_c(prec));
+    uint32_t size_a = m * k * size_ab;
+    uint32_t size_b = k * n * size_ab;
+    uint32_t size_c = m * n * size_c_elem;
+    uint32_t size_item =
+        ALIGN_UP(size_a, 8) + ALIGN_UP(size_b, 8) + ALIGN_UP(size_c, 8);
+    void* buffers = (void*)local_args + ALIGN_UP(sizeof(gemm_args_t), 8);
+    if ((uint32_t)buffers + 2 * group_size * size_item >
+        snrt_l1_allocator()->end)
+        return -1;
+
+    // Groups assigned to the current cluster
+    uint32_t num_groups = gemm_ceil_div(batch_count, group_size);
+    uint32_t cluster_idx = snrt_cluster_idx();
+    uint32_t num_clusters = snrt_cluster_num();
+    uint32_t cluster_groups =
+        num_groups > cluster_idx
+            ? gemm_ceil_div(num_groups - cluster_idx, num_clusters)
+            : 0;
+
+    // Software pipeline. In every step, the compute cores work on the
+    // previous group, while the DM core stores the results of the group
+    // before it, and loads the operands of the next group in its place.
+    uint32_t setup_ssr = local_args->setup_ssr;
+    for (uint32_t i = 0; i < cluster_groups + 2; i++) {
+        if (snrt_is_dm_core()) {
+            void* buffer = buffers + (i % 2) * group_size * size_item;
+
+            // Store results of group i - 2
+            if (i >= 2) {
+                uint32_t first = ((i - 2) * num_clusters + cluster_idx) *
+                                 group_size;
+                for (uint32_t j = 0; j < group_size; j++) {
+                    if (first + j >= batch_count) break;
+                    void* item = buffer + j * size_item;
+                    snrt_dma_start_1d(
+                        c + (first + j) * stride_c * size_c_elem,
+                        item + ALIGN_UP(size_a, 8) + ALIGN_UP(size_b, 8),
+                        size_c);
+                }
+                snrt_dma_wait_all();
+            }
+
+            // Load operands of group i. Shared operands are loaded only
+            // once in every buffer.
+            if (i < cluster_groups) {
+                uint32_t first = (i * num_clusters + cluster_idx) * group_size;
+                for (uint32_t j = 0; j < group_size; j++) {
+                    if (first + j >= batch_count) break;
+                    void* item = buffer + j * size_item;
+                    uint32_t idx = first + j;
+                    if (stride_a || i < 2)
+                        snrt_dma_start_1d(item, a + idx * stride_a * size_ab,
+                                          size_a);
+                    if (stride_b || i < 2)
+                        snrt_dma_start_1d(item + ALIGN_UP(size_a, 8),
+                                          b + idx * stride_b * size_ab,
+                                          size_b);
+                    if (beta)
+                        snrt_dma_start_1d(
+                            item + ALIGN_UP(size_a, 8) + ALIGN_UP(size_b, 8),
+                            c + idx * stride_c * size_c_elem, size_c);
                 }
+                snrt_dma_wait_all();
+            }
+        } else if (i >= 1 && i <= cluster_groups) {
+            // Compute group i - 1
+            void* buffer = buffers + ((i - 1) % 2) * group_size * size_item;
+            uint32_t first =
+                ((i - 1) * num_clusters + cluster_idx) * group_size;
+            uint32_t j = group_size > 1 ? compute_id : 0;
+            if (first + j < batch_count) {
+                void* item = buffer + j * size_item;
+                void* item_b = item + ALIGN_UP(size_a, 8);
+                void* item_c = item_b + ALIGN_UP(size_b, 8);
+                if (group_size > 1) {
+                    impl(m, n, k, item, k, transa, item_b, transb ? k : n,
+                         transb, item_c, n, beta, setup_ssr);
+                } else {
+                    sc_st_gemm_tile(local_args, m, n, k, item, item_b, beta,
+                                    item_c, setup_ssr);
+                }
+                setup_ssr = 0;
             }
         }
+        snrt_cluster_hw_barrier();
+    }
+
+    return 0;
+}
+
+// Parameters of the performance model used by gemm_plan(), and mirrored by
+// scripts/planner.py. Cycle counts are per cluster. They are derived as
+// follows, and are validated against, and can be recalibrated on, the
+// simulated cycles of the shape sweep in data/sweep.json, by the script in
+// target/snitch_cluster/sw/apps/blas/gemm/sweep:
+// - DMA_BW: one beat of the 512-bit DMA data path (dma_data_width in
+//   cfg/default.hjson) per cycle.
+// - DMA_LATENCY: issue of a 2D transfer, the round trip to L3 and the
+//   snrt_dma_wait_all() polling. An estimate, pending calibration.
+// - KERNEL_OVERHEAD: call, SSR descriptor setup and SSR enable/disable of
+//   gemm_fp64_opt, estimated from its instruction count.
+// - BLOCK_OVERHEAD: per 8-column block, the 8 accumulator initializations,
+//   the FREP setup and the 8 stores around the FMAs, plus loop control.
+// - SYNC_OVERHEAD: a cluster hardware barrier, including the wake-up of the
+//   DM core after the compute cores.
+#define GEMM_PLAN_DMA_BW 64            // DMA bandwidth, in bytes per cycle
+#define GEMM_PLAN_DMA_LATENCY 60       // Cycles per transfer
+#define GEMM_PLAN_KERNEL_OVERHEAD 100  // Cycles per kernel invocation
+#define GEMM_PLAN_BLOCK_OVERHEAD 20    // Cycles per 8-column block of a C row
+#define GEMM_PLAN_SYNC_OVERHEAD 40     // Cycles per synchronization
+
+static inline uint64_t gemm_plan_dma_cycles(uint32_t size) {
+    return GEMM_PLAN_DMA_LATENCY + gemm_ceil_div(size, GEMM_PLAN_DMA_BW);
+}
+
+// Predict the cycles gemm() takes on a given tiling. The prediction follows
+// the critical path, i.e. the cluster computing the most tiles, assuming all
+// tiles to be of full size. Every K iteration serially loads the A and B
+// tiles, runs the kernel, at one FMA per cycle and SIMD lane, and
+// synchronizes, as gemm() does not overlap transfers with computation. Every
+// output tile is then reduced across the clusters along K, and stored.
+static inline uint64_t gemm_plan_cycles(uint32_t m, uint32_t n, uint32_t k,
+                                        precision_t prec, uint32_t m_tiles,
+                                        uint32_t n_tiles, uint32_t k_tiles,
+                                        gemm_grid_t grid,
+                                        uint32_t num_cores) {
+    uint32_t frac_m = gemm_ceil_div(m, m_tiles);
+    uint32_t frac_n = gemm_ceil_div(n, n_tiles);
+    uint32_t frac_k = gemm_ceil_div(k, k_tiles);
+    uint32_t lanes = 8 / prec;
+
+    uint64_t kernel = GEMM_PLAN_KERNEL_OVERHEAD +
+                      (uint64_t)gemm_ceil_div(frac_m, num_cores) *
+                          gemm_ceil_div(frac_n, 8) *
+                          (8 * gemm_ceil_div(frac_k, lanes) +
+                           GEMM_PLAN_BLOCK_OVERHEAD);
+    uint64_t iteration = gemm_plan_dma_cycles(frac_m * frac_k * prec) +
+                         gemm_plan_dma_cycles(frac_k * frac_n * prec) +
+                         kernel + GEMM_PLAN_SYNC_OVERHEAD;
+
+    uint32_t size_c = frac_m * frac_n * prec;
+    uint64_t output = 2 * gemm_plan_dma_cycles(size_c);
+    for (uint32_t d = 1; d < grid.k; d *= 2)
+        output += gemm_plan_dma_cycles(size_c) +
+                  gemm_ceil_div(frac_m * frac_n, num_cores) +
+                  GEMM_PLAN_SYNC_OVERHEAD;
+
+    uint64_t num_outputs = (uint64_t)gemm_ceil_div(m_tiles, grid.m) *
+                           gemm_ceil_div(n_tiles, grid.n);
+    return num_outputs *
+           (gemm_ceil_div(k_tiles, grid.k) * iteration + output);
+}
+
+// TCDM footprint of a tiling, with double-buffered A and B tiles, and the
+// local copy of the epilogue and bias slice of `epi`, if not NULL. The
+// epilogue converts the output in place in the C tile.
+static inline uint32_t gemm_plan_footprint(uint32_t m, uint32_t n, uint32_t k,
+                                           precision_t prec, uint32_t m_tiles,
+                                           uint32_t n_tiles, uint32_t k_tiles,
+                                           gemm_grid_t grid,
+                                           gemm_epilogue_t* epi) {
+    uint32_t frac_m = gemm_ceil_div(m, m_tiles);
+    uint32_t frac_n = gemm_ceil_div(n, n_tiles);
+    uint32_t frac_k = gemm_ceil_div(k, k_tiles);
+    uint32_t size_c = ALIGN_UP(frac_m * frac_n * prec, 8);
+    uint32_t size_epi = 0;
+    if (epi) {
+        size_epi = ALIGN_UP(sizeof(gemm_epilogue_t), 8);
+        if (epi->bias != GEMM_BIAS_NONE)
+            size_epi += ALIGN_UP(
+                (epi->bias == GEMM_BIAS_ROW ? frac_m : frac_n) * prec, 8);
     }
+    return ALIGN_UP(sizeof(gemm_args_t), 8) + size_epi +
+           2 * ALIGN_UP(frac_m * frac_k * prec, 8) +
+           2 * ALIGN_UP(frac_k * frac_n * prec, 8) + size_c +
+           (grid.k > 1 ? size_c : 0);
+}
+
+// Tile counts considered by gemm_plan(): 1, 2, 3, 4, 6, 8, 12, 16, ...
+static inline uint32_t gemm_plan_next_tiles(uint32_t tiles) {
+    if (tiles == 1) return 2;
+    return (tiles & (tiles - 1)) ? tiles + tiles / 3 : tiles + tiles / 2;
+}
+
+// Whether every tile of a dimension is a multiple of `multiple` elements
+static inline uint32_t gemm_plan_tiles_aligned(uint32_t dim, uint32_t tiles,
+                                               uint32_t multiple) {
+    uint32_t frac = gemm_ceil_div(dim, tiles);
+    uint32_t last = dim - (gemm_ceil_div(dim, frac) - 1) * frac;
+    return (frac % multiple == 0) && (last % multiple == 0);
+}
+
+// Whether gemm_fp64_opt computes every N tile correctly. Its leftover
+// columns assume a transposed B, and its SSR loops need at least one block
+// of 8 columns.
+static inline uint32_t gemm_plan_fp64_opt_fits(uint32_t n, uint32_t tiles,
+                                               uint32_t transb) {
+    uint32_t frac = gemm_ceil_div(n, tiles);
+    uint32_t last = n - (gemm_ceil_div(n, frac) - 1) * frac;
+    if (!transb) return gemm_plan_tiles_aligned(n, tiles, 8);
+    return last >= 8;
+}
 
+// Plan a GEMM. Given the problem in `args`, i.e. M, N, K, prec, transa,
+// transb and the operand pointers, choose the tiling and parallelization
+// which minimize the cycles predicted by gemm_plan_cycles(), among those
+// fitting in `tcdm_size` bytes of TCDM with double buffering, together with
+// the epilogue in args->epilogue, if any, and complete `args` accordingly.
+// Operands are loaded from and stored to L3. If args->gemm_fp is not set, the
+// optimized kernel for the precision is selected. For FP64, this is
+// gemm_fp64_opt if all N tiles are multiples of its unrolling factor, and
+// gemm_fp64_opt_rb otherwise, which supports any tile and both layouts of B.
+// An explicitly set gemm_fp64_opt requires N tiles at least as wide as its
+// unrolling factor, and multiples of it unless B is transposed. The SIMD
+// kernels require a transposed B, and tiles whose N and K dimensions are
+// multiples of the unrolling factor and of the SIMD width respectively.
+// Integer precisions are not supported.
+// Returns 0 on success, -1 if the problem is not supported or does not fit.
+static inline int gemm_plan(gemm_args_t* args, uint32_t num_clusters,
+                            uint32_t tcdm_size) {
+    uint32_t m = args->M;
+    uint32_t n = args->N;
+    uint32_t k = args->K;
+    precision_t prec = (precision_t)args->prec;
+    uint32_t num_cores = snrt_cluster_compute_core_num();
+    uint32_t simd = prec != FP64;
+    uint32_t lanes = 8 / prec;
+
+    uint32_t fp64_opt = args->gemm_fp == gemm_fp64_opt;
+
+    if (prec & 0x10) return -1;
+    if (args->transa || (simd && !args->transb)) return -1;
+
+    uint64_t best_cycles = UINT64_MAX;
+    for (uint32_t mt = 1; mt <= m; mt = gemm_plan_next_tiles(mt)) {
+        for (uint32_t nt = 1; nt <= n; nt = gemm_plan_next_tiles(nt)) {
+            if (simd && !gemm_plan_tiles_aligned(n, nt, 8)) continue;
+            if (fp64_opt && !gemm_plan_fp64_opt_fits(n, nt, args->transb))
+                continue;
+            for (uint32_t kt = 1; kt <= k; kt = gemm_plan_next_tiles(kt)) {
+                if (simd && !gemm_plan_tiles_aligned(k, kt, lanes)) continue;
+
+                // Evaluate the grid gemm() would choose for this tiling
+                uint32_t m_tiles = gemm_ceil_div(m, gemm_ceil_div(m, mt));
+                uint32_t n_tiles = gemm_ceil_div(n, gemm_ceil_div(n, nt));
+                uint32_t k_tiles = gemm_ceil_div(k, gemm_ceil_div(k, kt));
+                uint32_t parallelize = num_clusters > 1;
+                gemm_grid_t grid = gemm_cluster_grid(
+                    m_tiles, n_tiles, k_tiles, parallelize, parallelize,
+                    parallelize, num_clusters);
+                if (gemm_plan_footprint(m, n, k, prec, m_tiles, n_tiles,
+                                        k_tiles, grid,
+                                        args->epilogue) > tcdm_size)
+                    continue;
+
+                uint64_t cycles = gemm_plan_cycles(m, n, k, prec, m_tiles,
+                                                   n_tiles, k_tiles, grid,
+                                                   num_cores);
+                if (cycles < best_cycles) {
+                    best_cycles = cycles;
+                    args->m_tiles = m_tiles;
+                    args->n_tiles = n_tiles;
+                    args->k_tiles = k_tiles;
+                    args->parallelize_m = parallelize;
+                    args->parallelize_n = parallelize;
+                    args->parallelize_k = parallelize;
+                }
+            }
+        }
+    }
+    if (best_cycles == UINT64_MAX) return -1;
+
+    args->setup_ssr = 1;
+    args->load_a = 1;
+    args->load_b = 1;
+    args->load_c = 1;
+    if (!args->gemm_fp) {
+        switch (prec) {
+            case FP64:
+                args->gemm_fp = gemm_plan_tiles_aligned(n, args->n_tiles, 8)
+                                    ? gemm_fp64_opt
+                                    : gemm_fp64_opt_rb;
+                break;
+            case FP32:
+                args->gemm_fp = gemm_fp32_opt;
+                break;
+            case FP16:
+                args->gemm_fp = gemm_fp16_opt;
+                break;
+            case FP8:
+                args->gemm_fp = gemm_fp8_opt_ex;
+                break;
+        }
+    }
     return 0;
 }
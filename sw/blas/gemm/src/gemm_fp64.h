@@ -73,43 +73,41 @@ void gemm_fp64_opt(uint32_t M, uint32_t N, uint32_t K, void* A_p, uint32_t ldA,
     // SSR strides and bounds only have to be configured
     // once in the beginning
     if (setup_SSR) {
+        const uint32_t ssr_b[4] = {unroll, K, N / unroll, M};
+
         // First matrix is stored in transposed format
+        snrt_ssr_desc_t ssr0_desc;
         if (ta) {
-            const uint32_t ssr0_b[4] = {unroll, K, N / unroll, M};
             const uint32_t ssr0_i[4] = {0, 8 * ldA, 0, 8 * 8};
-
-            snrt_ssr_loop_3d(SNRT_SSR_DM0, ssr0_b[1], ssr0_b[2], ssr0_b[3],
-                             ssr0_i[1], ssr0_i[2], ssr0_i[3]);
-            snrt_ssr_repeat(SNRT_SSR_DM0, unroll);
+            ssr0_desc = (snrt_ssr_desc_t)SNRT_SSR_DESC_3D(
+                ssr_b[1], ssr_b[2], ssr_b[3], ssr0_i[1], ssr0_i[2], ssr0_i[3]);
         } else {
-            const uint32_t ssr0_b[4] = {unroll, K, N / unroll, M};
             const uint32_t ssr0_i[4] = {0, 8, 0, 8 * ldA};
-
-            snrt_ssr_loop_3d(SNRT_SSR_DM0, ssr0_b[1], ssr0_b[2], ssr0_b[3],
-                             ssr0_i[1], ssr0_i[2], ssr0_i[3]);
-            snrt_ssr_repeat(SNRT_SSR_DM0, unroll);
+            ssr0_desc = (snrt_ssr_desc_t)SNRT_SSR_DESC_3D(
+                ssr_b[1], ssr_b[2], ssr_b[3], ssr0_i[1], ssr0_i[2], ssr0_i[3]);
         }
+        snrt_ssr_desc_repeat(&ssr0_desc, unroll);
 
         // Second matrix is stored in transposed format
+        snrt_ssr_desc_t ssr1_desc;
         if (tb) {
-            const uint32_t ssr1_b[4] = {unroll, K, N / unroll, M};
             const uint32_t ssr1_i[4] = {8 * ldB, 8, 8 * ldB * unroll, 0};
-
-            snrt_ssr_loop_4d(SNRT_SSR_DM1, ssr1_b[0], ssr1_b[1], ssr1_b[2],
-                             ssr1_b[3], ssr1_i[0], ssr1_i[1], ssr1_i[2],
-                             ssr1_i[3]);
+            ssr1_desc = (snrt_ssr_desc_t)SNRT_SSR_DESC_4D(
+                ssr_b[0], ssr_b[1], ssr_b[2], ssr_b[3], ssr1_i[0], ssr1_i[1],
+                ssr1_i[2], ssr1_i[3]);
         } else {
-            const uint32_t ssr1_b[4] = {unroll, K, N / unroll, M};
             const uint32_t ssr1_i[4] = {8, 8 * ldB, 8 * unroll, 0};
-
-            snrt_ssr_loop_4d(SNRT_SSR_DM1, ssr1_b[0], ssr1_b[1], ssr1_b[2],
-                             ssr1_b[3], ssr1_i[0], ssr1_i[1], ssr1_i[2],
-                             ssr1_i[3]);
+            ssr1_desc = (snrt_ssr_desc_t)SNRT_SSR_DESC_4D(
+                ssr_b[0], ssr_b[1], ssr_b[2], ssr_b[3], ssr1_i[0], ssr1_i[1],
+                ssr1_i[2], ssr1_i[3]);
         }
+
+        snrt_ssr_desc_apply(SNRT_SSR_DM0, &ssr0_desc);
+        snrt_ssr_desc_apply(SNRT_SSR_DM1, &ssr1_desc);
     }
 
     // SSR start address need to be configured each time
-    snrt_ssr_read(SNRT_SSR_DM0, SNRT_SSR_4D, A);
+    snrt_ssr_read(SNRT_SSR_DM0, SNRT_SSR_3D, A);
     snrt_ssr_read(SNRT_SSR_DM1, SNRT_SSR_4D, B);
     snrt_ssr_enable();
 
@@ -187,3 +185,197 @@ void gemm_fp64_opt(uint32_t M, uint32_t N, uint32_t K, void* A_p, uint32_t ldA,
 
     snrt_ssr_disable();
 }
+
+// The register-blocked kernel computes C in blocks of GEMM_FP64_RB_MR x
+// GEMM_FP64_RB_NR elements, each accumulated in registers over the whole K
+// dimension. For every k, the A elements of the block's rows are popped from
+// SSR0 into registers, while every B element is popped from SSR1 once per row,
+// using the SSR repetition. Every streamed element is thus reused across a
+// row or column of the block, reducing TCDM accesses from 1 + 1/8 per FMA in
+// gemm_fp64_opt's 1x8 kernel to 1/MR + 1/NR, at the cost of MR register moves
+// per MR x NR FMAs. The block size is bounded by the FREP sequencer, which
+// holds at most 16 instructions: a 2x8 block would need 18.
+#define GEMM_FP64_RB_MR 2
+#define GEMM_FP64_RB_NR 4
+
+// Micro-kernels. Every micro-kernel computes a single block of C, with the
+// dimensions given in the name, consuming the next K x MR elements of A from
+// SSR0 and the next K x NR elements of B from SSR1.
+
+static inline void gemm_fp64_ukernel_2x4(uint32_t K, double* C, uint32_t ldC,
+                                         uint32_t BETA) {
+    double c[2][4];
+    double a[2];
+    for (uint32_t i = 0; i < 2; i++)
+        for (uint32_t j = 0; j < 4; j++)
+            c[i][j] = BETA ? C[i * ldC + j] : 0.0;
+    asm volatile(
+        "frep.o %[n_frep], 10, 0, 0 \n"
+        "fmv.d %[a0], ft0 \n"
+        "fmv.d %[a1], ft0 \n"
+        "fmadd.d %[c00], %[a0], ft1, %[c00] \n"
+        "fmadd.d %[c10], %[a1], ft1, %[c10] \n"
+        "fmadd.d %[c01], %[a0], ft1, %[c01] \n"
+        "fmadd.d %[c11], %[a1], ft1, %[c11] \n"
+        "fmadd.d %[c02], %[a0], ft1, %[c02] \n"
+        "fmadd.d %[c12], %[a1], ft1, %[c12] \n"
+        "fmadd.d %[c03], %[a0], ft1, %[c03] \n"
+        "fmadd.d %[c13], %[a1], ft1, %[c13] \n"
+        : [ c00 ] "+f"(c[0][0]), [ c01 ] "+f"(c[0][1]), [ c02 ] "+f"(c[0][2]),
+          [ c03 ] "+f"(c[0][3]), [ c10 ] "+f"(c[1][0]), [ c11 ] "+f"(c[1][1]),
+          [ c12 ] "+f"(c[1][2]), [ c13 ] "+f"(c[1][3]), [ a0 ] "=&f"(a[0]),
+          [ a1 ] "=&f"(a[1])
+        : [ n_frep ] "r"(K - 1)
+        : "ft0", "ft1", "ft2");
+    for (uint32_t i = 0; i < 2; i++)
+        for (uint32_t j = 0; j < 4; j++) C[i * ldC + j] = c[i][j];
+}
+
+static inline void gemm_fp64_ukernel_2x1(uint32_t K, double* C, uint32_t ldC,
+                                         uint32_t BETA) {
+    double c0 = BETA ? C[0] : 0.0;
+    double c1 = BETA ? C[ldC] : 0.0;
+    double a0, a1;
+    asm volatile(
+        "frep.o %[n_frep], 4, 0, 0 \n"
+        "fmv.d %[a0], ft0 \n"
+        "fmv.d %[a1], ft0 \n"
+        "fmadd.d %[c0], %[a0], ft1, %[c0] \n"
+        "fmadd.d %[c1], %[a1], ft1, %[c1] \n"
+        : [ c0 ] "+f"(c0), [ c1 ] "+f"(c1), [ a0 ] "=&f"(a0), [ a1 ] "=&f"(a1)
+        : [ n_frep ] "r"(K - 1)
+        : "ft0", "ft1", "ft2");
+    C[0] = c0;
+    C[ldC] = c1;
+}
+
+// Single-row micro-kernels. The A element is repeated by SSR0, so these
+// stream directly from both SSRs, as gemm_fp64_opt does.
+
+static inline void gemm_fp64_ukernel_1x4(uint32_t K, double* C, uint32_t ldC,
+                                         uint32_t BETA) {
+    double c[4];
+    for (uint32_t j = 0; j < 4; j++) c[j] = BETA ? C[j] : 0.0;
+    asm volatile(
+        "frep.o %[n_frep], 4, 0, 0 \n"
+        "fmadd.d %[c0], ft0, ft1, %[c0] \n"
+        "fmadd.d %[c1], ft0, ft1, %[c1] \n"
+        "fmadd.d %[c2], ft0, ft1, %[c2] \n"
+        "fmadd.d %[c3], ft0, ft1, %[c3] \n"
+        : [ c0 ] "+f"(c[0]), [ c1 ] "+f"(c[1]), [ c2 ] "+f"(c[2]),
+          [ c3 ] "+f"(c[3])
+        : [ n_frep ] "r"(K - 1)
+        : "ft0", "ft1", "ft2");
+    for (uint32_t j = 0; j < 4; j++) C[j] = c[j];
+}
+
+static inline void gemm_fp64_ukernel_1x1(uint32_t K, double* C, uint32_t ldC,
+                                         uint32_t BETA) {
+    double c0 = BETA ? C[0] : 0.0;
+    asm volatile(
+        "frep.o %[n_frep], 1, 0, 0 \n"
+        "fmadd.d %[c0], ft0, ft1, %[c0] \n"
+        : [ c0 ] "+f"(c0)
+        : [ n_frep ] "r"(K - 1)
+        : "ft0", "ft1", "ft2");
+    C[0] = c0;
+}
+
+// Computes an M x N region of C, with M and N multiples of the micro-kernel
+// dimensions mr and nr, iterating the micro-kernel over the blocks of the
+// region in row-major order. The SSRs are programmed to stream the operands
+// of all blocks in the same order.
+static inline void gemm_fp64_opt_rb_region(uint32_t mr, uint32_t nr, uint32_t M,
+                                           uint32_t N, uint32_t K, double* A,
+                                           uint32_t ldA, uint32_t ta, double* B,
+                                           uint32_t ldB, uint32_t tb, double* C,
+                                           uint32_t ldC, uint32_t BETA) {
+    // Byte strides between consecutive elements of A along M and K, and of B
+    // along N and K
+    uint32_t a_m = ta ? 8 : 8 * ldA;
+    uint32_t a_k = ta ? 8 * ldA : 8;
+    uint32_t b_n = tb ? 8 * ldB : 8;
+    uint32_t b_k = tb ? 8 : 8 * ldB;
+
+    // For every block and k, stream the mr elements of A in the block's rows,
+    // each repeated nr times in the single-row micro-kernels
+    snrt_ssr_desc_t ssr0_desc = (snrt_ssr_desc_t)SNRT_SSR_DESC_4D(
+        mr, K, N / nr, M / mr, a_m, a_k, 0, mr * a_m);
+    snrt_ssr_desc_repeat(&ssr0_desc, mr == 1 ? nr : 1);
+
+    // For every block and k, stream the nr elements of B in the block's
+    // columns, each repeated once per row
+    snrt_ssr_desc_t ssr1_desc = (snrt_ssr_desc_t)SNRT_SSR_DESC_4D(
+        nr, K, N / nr, M / mr, b_n, b_k, nr * b_n, 0);
+    snrt_ssr_desc_repeat(&ssr1_desc, mr);
+
+    snrt_ssr_desc_apply(SNRT_SSR_DM0, &ssr0_desc);
+    snrt_ssr_desc_apply(SNRT_SSR_DM1, &ssr1_desc);
+    snrt_ssr_read(SNRT_SSR_DM0, SNRT_SSR_4D, A);
+    snrt_ssr_read(SNRT_SSR_DM1, SNRT_SSR_4D, B);
+    snrt_ssr_enable();
+
+    for (uint32_t m = 0; m < M; m += mr) {
+        for (uint32_t n = 0; n < N; n += nr) {
+            double* c = C + m * ldC + n;
+            switch (mr * 16 + nr) {
+                case 0x24:
+                    gemm_fp64_ukernel_2x4(K, c, ldC, BETA);
+                    break;
+                case 0x21:
+                    gemm_fp64_ukernel_2x1(K, c, ldC, BETA);
+                    break;
+                case 0x14:
+                    gemm_fp64_ukernel_1x4(K, c, ldC, BETA);
+                    break;
+                default:
+                    gemm_fp64_ukernel_1x1(K, c, ldC, BETA);
+                    break;
+            }
+        }
+    }
+
+    snrt_ssr_disable();
+}
+
+// Register-blocked variant of gemm_fp64_opt. C is partitioned into regions,
+// each computed with the widest micro-kernel that fits: the bulk of C with
+// the 2x4 micro-kernel, the leftover columns with the 2x1 micro-kernel, and
+// the leftover row with the single-row micro-kernels.
+// Unlike gemm_fp64_opt, the leftover columns are thus also computed with the
+// SSRs and FREP.
+// Since every region requires a different SSR configuration, the SSRs are
+// always configured, regardless of setup_SSR.
+void gemm_fp64_opt_rb(uint32_t M, uint32_t N, uint32_t K, void* A_p,
+                      uint32_t ldA, uint32_t ta, void* B_p, uint32_t ldB,
+                      uint32_t tb, void* C_p, uint32_t ldC, uint32_t BETA,
+                      uint32_t setup_SSR) {
+    double* A = (double*)A_p;
+    double* B = (double*)B_p;
+    double* C = (double*)C_p;
+
+    const uint32_t mrs[2] = {GEMM_FP64_RB_MR, 1};
+    const uint32_t nrs[2] = {GEMM_FP64_RB_NR, 1};
+
+    uint32_t m0 = 0;
+    for (uint32_t i = 0; i < 2; i++) {
+        uint32_t mr = mrs[i];
+        uint32_t rows = (M - m0) / mr * mr;
+        if (rows == 0) continue;
+
+        uint32_t n0 = 0;
+        for (uint32_t j = 0; j < 2; j++) {
+            uint32_t nr = nrs[j];
+            uint32_t cols = (N - n0) / nr * nr;
+            if (cols == 0) continue;
+
+            double* A_r = A + (ta ? m0 : m0 * ldA);
+            double* B_r = B + (tb ? n0 * ldB : n0);
+            double* C_r = C + m0 * ldC + n0;
+            gemm_fp64_opt_rb_region(mr, nr, rows, cols, K, A_r, ldA, ta, B_r,
+                                    ldB, tb, C_r, ldC, BETA);
+            n0 += cols;
+        }
+        m0 += rows;
+    }
+}
@@ -0,0 +1,11 @@
+// Copyright 2024 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+//
+// GEMM kernels on INT16 operands, instantiated from gemm_int.h
+
+#define GEMM_INT_T int16_t
+#define GEMM_INT_NAME gemm_i16
+#include "gemm_int.h"
+#undef GEMM_INT_NAME
+#undef GEMM_INT_T
@@ -0,0 +1,90 @@
+// Copyright 2024 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+//
+// GEMM kernels on integer operands, accumulating into an INT32 C matrix. The
+// SSRs can only stream to the FPU, so these kernels run on the integer core,
+// and offload the multiplications to the cluster's shared MULDIV unit.
+// Transposed A matrices are not supported.
+//
+// This header is a template, included once per operand type by gemm_i8.h and
+// gemm_i16.h. Before including it, define GEMM_INT_T as the operand type and
+// GEMM_INT_NAME as the name prefix of the kernels, e.g. gemm_i8, which then
+// become gemm_i8_naive and gemm_i8_opt.
+
+#define GEMM_INT_CONCAT(prefix, impl) prefix##_##impl
+#define GEMM_INT_EXPAND(prefix, impl) GEMM_INT_CONCAT(prefix, impl)
+#define GEMM_INT_KERNEL(impl) GEMM_INT_EXPAND(GEMM_INT_NAME, impl)
+
+void GEMM_INT_KERNEL(naive)(uint32_t M, uint32_t N, uint32_t K, void* A_p,
+                            uint32_t ldA, uint32_t ta, void* B_p, uint32_t ldB,
+                            uint32_t tb, void* C_p, uint32_t ldC, uint32_t BETA,
+                            uint32_t setup_SSR) {
+    GEMM_INT_T* A = (GEMM_INT_T*)A_p;
+    GEMM_INT_T* B = (GEMM_INT_T*)B_p;
+    int32_t* C = (int32_t*)C_p;
+
+    for (uint32_t m = 0; m < M; m++) {
+        for (uint32_t n = 0; n < N; n++) {
+            int32_t c0 = BETA ? C[m * ldC + n] : 0;
+            for (uint32_t k = 0; k < K; k++) {
+                int32_t b = tb ? B[k + n * ldB] : B[k * ldB + n];
+                c0 += A[k + m * ldA] * b;
+            }
+            C[m * ldC + n] = c0;
+        }
+    }
+}
+
+// Every element of A is reused for four columns of C, accumulated in
+// registers
+void GEMM_INT_KERNEL(opt)(uint32_t M, uint32_t N, uint32_t K, void* A_p,
+                          uint32_t ldA, uint32_t ta, void* B_p, uint32_t ldB,
+                          uint32_t tb, void* C_p, uint32_t ldC, uint32_t BETA,
+                          uint32_t setup_SSR) {
+    GEMM_INT_T* A = (GEMM_INT_T*)A_p;
+    GEMM_INT_T* B = (GEMM_INT_T*)B_p;
+    int32_t* C = (int32_t*)C_p;
+
+    // Distance between consecutive elements of B along N and K
+    uint32_t b_n = tb ? ldB : 1;
+    uint32_t b_k = tb ? 1 : ldB;
+
+    for (uint32_t m = 0; m < M; m++) {
+        GEMM_INT_T* a = A + m * ldA;
+        int32_t* c = C + m * ldC;
+        uint32_t n = 0;
+        for (; n + 4 <= N; n += 4) {
+            GEMM_INT_T* b = B + n * b_n;
+            int32_t c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+            if (BETA) {
+                c0 = c[n];
+                c1 = c[n + 1];
+                c2 = c[n + 2];
+                c3 = c[n + 3];
+            }
+            for (uint32_t k = 0; k < K; k++) {
+                int32_t a0 = a[k];
+                c0 += a0 * b[0];
+                c1 += a0 * b[b_n];
+                c2 += a0 * b[2 * b_n];
+                c3 += a0 * b[3 * b_n];
+                b += b_k;
+            }
+            c[n] = c0;
+            c[n + 1] = c1;
+            c[n + 2] = c2;
+            c[n + 3] = c3;
+        }
+        for (; n < N; n++) {
+            GEMM_INT_T* b = B + n * b_n;
+            int32_t c0 = BETA ? c[n] : 0;
+            for (uint32_t k = 0; k < K; k++) c0 += a[k] * b[k * b_k];
+            c[n] = c0;
+        }
+    }
+}
+
+#undef GEMM_INT_KERNEL
+#undef GEMM_INT_EXPAND
+#undef GEMM_INT_CONCAT
@@ -15,12 +15,22 @@
 #include "snrt.h"
 
 int main() {
+    uint32_t start_cycle = snrt_mcycle();
     int retcode = gemm(&args);
 
-    snrt_cluster_hw_barrier();
+    snrt_global_barrier();
+
+    // Report the runtime, e.g. to validate the model in scripts/planner.py
+    if (snrt_global_core_idx() == 0) {
+        printf(
+            "[gemm] prec=%u M=%u N=%u K=%u m_tiles=%u n_tiles=%u k_tiles=%u "
+            "parallelize=%u%u%u clusters=%u cycles=%u\n",
+            args.prec, args.M, args.N, args.K, args.m_tiles, args.n_tiles,
+            args.k_tiles, args.parallelize_m, args.parallelize_n,
+            args.parallelize_k, snrt_cluster_num(),
+            snrt_mcycle() - start_cycle);
+    }
 
-// TODO: currently only works for single cluster otherwise need to
-//       synchronize all cores here
 #ifdef BIST
     void *local_a, *local_b, *local_c;
     void *remote_a, *remote_b, *remote_c;
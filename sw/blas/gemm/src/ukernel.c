@@ -0,0 +1,74 @@
+// Copyright 2024 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+//
+// Benchmark of the FP64 GEMM micro-kernels. Runs the 1x8 kernel of
+// gemm_fp64_opt and the register-blocked kernel of gemm_fp64_opt_rb on the
+// same single-cluster problem, with all operands in TCDM, and reports the
+// FPU utilization of each. The results of the two kernels are compared, and
+// must match exactly as both accumulate every element in the same order.
+
+#include <stdint.h>
+
+#include "blas.h"
+
+#include "data.h"
+#include "snrt.h"
+
+// Run a kernel on the whole problem and return the elapsed cycles
+static inline uint32_t run_kernel(gemm_fp_t kernel, void *a, void *b, void *c) {
+    gemm_args_t kernel_args = args;
+    kernel_args.gemm_fp = kernel;
+
+    snrt_cluster_hw_barrier();
+    uint32_t start = snrt_mcycle();
+    sc_st_gemm_tile(&kernel_args, args.M, args.N, args.K, a, b, args.beta, c,
+                    1);
+    snrt_cluster_hw_barrier();
+    return snrt_mcycle() - start;
+}
+
+static inline void report(const char *name, uint32_t cycles) {
+    // FPU utilization in units of 0.1%
+    uint32_t fmas = args.M * args.N * args.K;
+    uint32_t util =
+        (1000ULL * fmas) / ((uint64_t)cycles * snrt_cluster_compute_core_num());
+    printf("[gemm_ukernel] %s M=%u N=%u K=%u cycles=%u util=%u.%u%%\n", name,
+           args.M, args.N, args.K, cycles, util / 10, util % 10);
+}
+
+int main() {
+    if (snrt_cluster_idx() != 0) return 0;
+
+    uint32_t size_a = args.M * args.K * sizeof(double);
+    uint32_t size_b = args.K * args.N * sizeof(double);
+    uint32_t size_c = args.M * args.N * sizeof(double);
+
+    // Allocate space in TCDM
+    double *local_a = (double *)snrt_l1_next();
+    double *local_b = local_a + args.M * args.K;
+    double *local_c_opt = local_b + args.K * args.N;
+    double *local_c_rb = local_c_opt + args.M * args.N;
+
+    if (snrt_is_dm_core()) {
+        snrt_dma_start_1d(local_a, a, size_a);
+        snrt_dma_start_1d(local_b, b, size_b);
+        snrt_dma_start_1d(local_c_opt, c, size_c);
+        snrt_dma_start_1d(local_c_rb, c, size_c);
+        snrt_dma_wait_all();
+    }
+
+    uint32_t cycles_opt =
+        run_kernel(gemm_fp64_opt, local_a, local_b, local_c_opt);
+    uint32_t cycles_rb = run_kernel(gemm_fp64_opt_rb, local_a, local_b,
+                                    local_c_rb);
+
+    uint32_t errors = 0;
+    if (snrt_cluster_core_idx() == 0) {
+        report("1x8", cycles_opt);
+        report("2x4", cycles_rb);
+        for (uint32_t i = 0; i < args.M * args.N; i++)
+            errors += local_c_rb[i] != local_c_opt[i];
+    }
+    return errors;
+}
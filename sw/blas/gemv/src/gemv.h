@@ -20,9 +20,27 @@ typedef struct {
     double *y;
 } gemv_args_t;
 
+// Size in bytes of the panels in which gemv_job() streams A from L3.
+// Every panel is double buffered in TCDM.
+#ifndef GEMV_PANEL_SIZE
+#define GEMV_PANEL_SIZE 16384
+#endif
+
+// Distributes n rows over `num` parts as evenly as possible. The first
+// parts get one row more than the others.
+static inline void gemv_split(uint32_t n, uint32_t part, uint32_t num,
+                              uint32_t *start, uint32_t *len) {
+    uint32_t frac = n / num;
+    uint32_t rem = n % num;
+    *start = part * frac + (part < rem ? part : rem);
+    *len = frac + (part < rem);
+}
+
+// If `accumulate` is set, the result is added to y instead of overwriting it.
 static inline void single_core_gemv(uint32_t trans, uint32_t m, uint32_t n,
                                     double alpha, double *a, uint32_t lda,
-                                    double *x, uint32_t incx, double *y) {
+                                    double *x, uint32_t incx, double *y,
+                                    uint32_t accumulate) {
     // Configure SSR 0 to stream a
     uint32_t ssr0_b[2] = {n, m};
     if (trans) {
@@ -46,18 +64,25 @@ static inline void single_core_gemv(uint32_t trans, uint32_t m, uint32_t n,
     snrt_ssr_enable();
 
     for (uint32_t i = 0; i < m; i++) {
-        double acc = 0.0;
+        double acc;
 
+        // The whole row is computed and stored in assembly, as ft0-ft2 are
+        // reserved to the SSRs
         asm volatile(
+            "fcvt.d.w %[acc], zero \n"
             "fld ft3, 0(%[alpha]) \n"
             "frep.o %[n_frep], 1, 0, 0 \n"
             "fmadd.d %[acc], ft0, ft1, %[acc] \n"
             "fmul.d %[acc], %[acc], ft3 \n"
-            : [ acc ] "+f"(acc)
-            : [ n_frep ] "r"(n - 1), [ alpha ] "r"(&alpha)
+            "beqz %[accumulate], 1f \n"
+            "fld ft3, 0(%[y]) \n"
+            "fadd.d %[acc], %[acc], ft3 \n"
+            "1: \n"
+            "fsd %[acc], 0(%[y]) \n"
+            : [ acc ] "=&f"(acc)
+            : [ n_frep ] "r"(n - 1), [ alpha ] "r"(&alpha), [ y ] "r"(&y[i]),
+              [ accumulate ] "r"(accumulate)
             : "ft0", "ft1", "ft2", "ft3", "memory");
-
-        y[i] = acc;
     }
     snrt_ssr_disable();
     snrt_fpu_fence();
@@ -67,17 +92,12 @@ static inline void single_core_gemv(uint32_t trans, uint32_t m, uint32_t n,
 // to compress vectors with a single value.
 static inline void gemv(uint32_t trans, uint32_t m, uint32_t n, double alpha,
                         double *a, double *x, uint32_t incx, double *y) {
-    uint32_t frac_m, rem_m, start_m, core_m, lda;
+    uint32_t start_m, core_m, lda;
     double *core_a;
 
-    // Distribute rows to cores in cluster.
-    // Last core computes remainder rows
-    frac_m = m / snrt_cluster_compute_core_num();
-    rem_m = m % snrt_cluster_compute_core_num();
-    start_m = snrt_cluster_core_idx() * frac_m;
-    core_m = snrt_cluster_core_idx() == (snrt_cluster_compute_core_num() - 1)
-                 ? frac_m + rem_m
-                 : frac_m;
+    // Distribute rows evenly to cores in cluster
+    gemv_split(m, snrt_cluster_core_idx(), snrt_cluster_compute_core_num(),
+               &start_m, &core_m);
     if (trans) {
         lda = m;
         core_a = &a[start_m];
@@ -89,5 +109,125 @@ static inline void gemv(uint32_t trans, uint32_t m, uint32_t n, double alpha,
     // Every core computes its portion of rows
     if (core_m > 0)
         single_core_gemv(trans, core_m, n, alpha, core_a, lda, x, incx,
-                         &y[start_m]);
+                         &y[start_m], 0);
+}
+
+// Loads `rows` consecutive rows of A, as stored in memory, starting at row
+// `row`. Of every row, only the `len` elements starting at `col` are loaded.
+static inline void gemv_load_panel(double *dst, double *a, uint32_t lda,
+                                   uint32_t row, uint32_t col, uint32_t rows,
+                                   uint32_t len) {
+    double *src = a + row * lda + col;
+    if (len == lda)
+        snrt_dma_start_1d(dst, src, rows * len * sizeof(double));
+    else
+        snrt_dma_start_2d(dst, src, len * sizeof(double), len * sizeof(double),
+                          lda * sizeof(double), rows);
+}
+
+// GEMV on operands of arbitrary size in L3, as described by `args`.
+// The rows of y are split evenly over all clusters. Every cluster keeps x and
+// its part of y resident in TCDM, and streams the corresponding part of A in
+// panels of GEMV_PANEL_SIZE bytes, loading the next panel while all compute
+// cores work on the current one. Panels consist of whole rows of A as stored
+// in memory: in the non-transposed case every panel contributes some rows of
+// y, which are split evenly over the cores. In the transposed case every
+// panel holds some columns of A, whose contribution is accumulated into all
+// of the cluster's rows of y. Must be called by all cores in all clusters.
+static inline void gemv_job(gemv_args_t *args) {
+    uint32_t trans = args->trans;
+    uint32_t m = args->m;
+    uint32_t n = args->n;
+    double alpha = args->alpha;
+    double *a = args->a;
+    uint32_t core_idx = snrt_cluster_core_idx();
+    uint32_t num_cores = snrt_cluster_compute_core_num();
+
+    // Rows of y assigned to this cluster
+    uint32_t cluster_start, cluster_m;
+    gemv_split(m, snrt_cluster_idx(), snrt_cluster_num(), &cluster_start,
+               &cluster_m);
+    if (cluster_m == 0) return;
+
+    // Shape of the part of A streamed by this cluster, as stored in memory
+    uint32_t lda = trans ? m : n;
+    uint32_t row_len = trans ? cluster_m : n;
+    uint32_t n_rows = trans ? n : cluster_m;
+    uint32_t row_offset = trans ? 0 : cluster_start;
+    uint32_t col_offset = trans ? cluster_start : 0;
+
+    // Every panel holds at least one row
+    uint32_t panel_rows = GEMV_PANEL_SIZE / (row_len * sizeof(double));
+    if (panel_rows == 0) panel_rows = 1;
+    uint32_t panel_size = panel_rows * row_len;
+    uint32_t n_panels = (n_rows + panel_rows - 1) / panel_rows;
+
+    // Allocate x, y and the panel buffers in TCDM
+    double *local_x =
+        snrt_l1_alloc_cluster_local(n * sizeof(double), sizeof(double));
+    double *local_y =
+        snrt_l1_alloc_cluster_local(cluster_m * sizeof(double), sizeof(double));
+    double *local_a[2];
+    local_a[0] = snrt_l1_alloc_cluster_local(panel_size * sizeof(double),
+                                             sizeof(double));
+    local_a[1] = snrt_l1_alloc_cluster_local(panel_size * sizeof(double),
+                                             sizeof(double));
+
+    // Load x and prefetch the first panel
+    if (snrt_is_dm_core()) {
+        snrt_dma_start_1d(local_x, args->x, n * sizeof(double));
+        gemv_load_panel(local_a[0], a, lda, row_offset, col_offset,
+                        n_rows < panel_rows ? n_rows : panel_rows, row_len);
+    }
+
+    // In the transposed case the split of y over the cores is fixed
+    uint32_t core_start, core_m;
+    gemv_split(cluster_m, core_idx, num_cores, &core_start, &core_m);
+
+    for (uint32_t p = 0; p < n_panels; p++) {
+        uint32_t first_row = p * panel_rows;
+        uint32_t rows = n_rows - first_row;
+        if (rows > panel_rows) rows = panel_rows;
+        double *panel = local_a[p % 2];
+
+        // Wait for the current panel. The barrier also ensures that all
+        // cores are done with the previous panel, whose buffer is refilled.
+        if (snrt_is_dm_core()) snrt_dma_wait_all();
+        snrt_cluster_hw_barrier();
+
+        if (snrt_is_dm_core() && p + 1 < n_panels) {
+            uint32_t next_row = first_row + panel_rows;
+            uint32_t next_rows = n_rows - next_row;
+            if (next_rows > panel_rows) next_rows = panel_rows;
+            gemv_load_panel(local_a[(p + 1) % 2], a, lda, row_offset + next_row,
+                            col_offset, next_rows, row_len);
+        }
+
+        if (snrt_is_compute_core()) {
+            if (trans) {
+                if (core_m)
+                    single_core_gemv(1, core_m, rows, alpha, panel + core_start,
+                                     cluster_m, local_x + first_row, 1,
+                                     local_y + core_start, p > 0);
+            } else {
+                uint32_t row_start, row_m;
+                gemv_split(rows, core_idx, num_cores, &row_start, &row_m);
+                if (row_m)
+                    single_core_gemv(0, row_m, n, alpha,
+                                     panel + row_start * n, n, local_x, 1,
+                                     local_y + first_row + row_start, 0);
+            }
+        }
+    }
+
+    // Store the cluster's part of y
+    snrt_cluster_hw_barrier();
+    if (snrt_is_dm_core()) {
+        snrt_dma_start_1d(args->y + cluster_start, local_y,
+                          cluster_m * sizeof(double));
+        snrt_dma_wait_all();
+    }
+
+    snrt_l1_update_next_v2(local_x);
+    snrt_cluster_hw_barrier();
 }
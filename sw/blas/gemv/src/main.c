@@ -9,38 +9,34 @@
 #include "data.h"
 #include "snrt.h"
 
-int main() {
-    uint32_t trans = args.trans;
-    uint32_t m = args.m;
-    uint32_t n = args.n;
-    double alpha = args.alpha;
-    double *a = args.a;
-    double *x = args.x;
-    double *y = args.y;
-
-    uint32_t size_a = m * n * sizeof(double);
-    uint32_t size_x = n * sizeof(double);
-    uint32_t size_y = m * sizeof(double);
-
-    double *local_a = snrt_l1_alloc_cluster_local(size_a, sizeof(double));
-    double *local_x = snrt_l1_alloc_cluster_local(size_x, sizeof(double));
-    double *local_y = snrt_l1_alloc_cluster_local(size_y, sizeof(double));
-
-    if (snrt_is_dm_core()) {
-        snrt_dma_start_1d(local_a, a, size_a);
-        snrt_dma_start_1d(local_x, x, size_x);
-    }
+// Peak bandwidth of a cluster's DMA, in bytes per cycle
+#define DMA_PEAK_BW 64
 
-    snrt_cluster_hw_barrier();
-
-    if (snrt_is_compute_core()) {
-        gemv(trans, m, n, alpha, local_a, local_x, 1, local_y);
-    }
-
-    snrt_cluster_hw_barrier();
-
-    if (snrt_is_dm_core()) {
-        snrt_dma_start_1d(y, local_y, size_y);
+int main() {
+    snrt_global_barrier();
+    uint32_t start_cycle = snrt_mcycle();
+
+    gemv_job(&args);
+
+    snrt_global_barrier();
+    uint32_t cycles = snrt_mcycle() - start_cycle;
+
+    // Report the bandwidth utilization relative to the aggregate DMA peak
+    // of all clusters. Every cluster loads the whole of x.
+    if (snrt_global_core_idx() == 0) {
+        uint32_t num_clusters = snrt_cluster_num();
+        uint64_t bytes =
+            (uint64_t)(args.m * args.n + num_clusters * args.n + args.m) *
+            sizeof(double);
+        uint32_t bw = (uint32_t)(100 * bytes / cycles);
+        uint32_t util =
+            (uint32_t)(1000 * bytes / ((uint64_t)cycles * DMA_PEAK_BW *
+                                       num_clusters));
+        printf(
+            "[gemv] m=%u n=%u trans=%u clusters=%u cycles=%u bytes=%u "
+            "bw=%u.%02u B/cycle util=%u.%u%%\n",
+            args.m, args.n, args.trans, num_clusters, cycles,
+            (uint32_t)bytes, bw / 100, bw % 100, util / 10, util % 10);
     }
 
     return 0;
@@ -0,0 +1,52 @@
+#!/usr/bin/env python3
+# Copyright 2024 ETH Zurich and University of Bologna.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+import numpy as np
+
+import snitch.util.sim.data_utils as du
+
+
+class PotrfDataGen(du.DataGen):
+
+    def golden_model(self, A):
+        return np.linalg.cholesky(A)
+
+    def validate(self, **kwargs):
+        n_cores = 8
+        assert (kwargs['m'] % kwargs['m_tiles']) == 0, "m must be an integer multiple of m_tiles"
+        tile = kwargs['m'] // kwargs['m_tiles']
+        assert (tile % n_cores) == 0, "tile size must be an integer multiple of the number of cores"
+        assert (tile % 4) == 0, "tile size must be an integer multiple of the unroll factor 4"
+
+        # Output tile and two operand tiles
+        du.validate_tcdm_footprint(3 * tile * tile * 8)
+
+    def emit_header(self, **kwargs):
+        header = [super().emit_header()]
+
+        self.validate(**kwargs)
+
+        # Symmetric positive definite matrix, as e.g. a covariance matrix
+        m = kwargs['m']
+        R = du.generate_random_array((m, m))
+        A = np.matmul(R, R.transpose()) + m * np.eye(m)
+
+        A_uid = 'A'
+
+        cfg = {
+            'm': m,
+            'm_tiles': kwargs['m_tiles'],
+            'a': A_uid
+        }
+
+        header += [du.format_array_definition('double', A_uid, A.flatten())]
+        header += [du.format_struct_definition('potrf_args_t', 'args', cfg)]
+        header = '\n\n'.join(header)
+
+        return header
+
+
+if __name__ == '__main__':
+    PotrfDataGen().main()
@@ -0,0 +1,44 @@
+#!/usr/bin/env python3
+# Copyright 2024 ETH Zurich and University of Bologna.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+import numpy as np
+import sys
+from datagen import PotrfDataGen
+
+from snitch.util.sim.verif_utils import Verifier
+
+
+class PotrfVerifier(Verifier):
+
+    OUTPUT_UIDS = ['A']
+
+    def __init__(self):
+        super().__init__()
+        self.func_args = {
+            'm': 'I',
+            'm_tiles': 'I',
+            'A': 'I'
+        }
+        self.func_args = self.get_input_from_symbol('args', self.func_args)
+
+    # Only the lower triangle of A is overwritten with L
+    def lower_triangle(self, A):
+        m = self.func_args['m']
+        return np.reshape(A, (m, m))[np.tril_indices(m)]
+
+    def get_actual_results(self):
+        return self.lower_triangle(self.get_output_from_symbol(self.OUTPUT_UIDS[0], 'double'))
+
+    def get_expected_results(self):
+        m = self.func_args['m']
+        A = np.reshape(self.get_input_from_symbol('A', 'double'), (m, m))
+        return self.lower_triangle(PotrfDataGen().golden_model(A))
+
+    def check_results(self, *args):
+        return super().check_results(*args, atol=1e-10)
+
+
+if __name__ == "__main__":
+    sys.exit(PotrfVerifier().main())
@@ -0,0 +1,14 @@
+// Copyright 2024 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "snrt.h"
+
+#include "blas.h"
+#include "data.h"
+
+int main() {
+    potrf_job(&args);
+
+    return 0;
+}
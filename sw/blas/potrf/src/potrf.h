@@ -0,0 +1,148 @@
+// Copyright 2024 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <stdint.h>
+
+#include "snrt.h"
+#include "syrk/src/syrk.h"
+#include "trsm/src/trsm.h"
+
+// Cholesky factorization A = L L^T of a symmetric positive definite m x m
+// matrix, stored in row-major order. L overwrites the lower triangle of A,
+// the strictly upper triangle is left in an unspecified state.
+typedef struct {
+    uint32_t m;
+    uint32_t m_tiles;
+    double *a;
+} potrf_args_t;
+
+// Cholesky factorization of an m x m tile, stored densely. Column by column,
+// core 0 computes the diagonal element, then the elements below it are
+// distributed over the compute cores, which scale them by its reciprocal.
+// Must be called by all cores of the cluster.
+static inline void potrf_tile(uint32_t m, double *a) {
+    uint32_t offset = snrt_cluster_core_idx();
+    uint32_t stride = snrt_cluster_compute_core_num();
+
+    for (uint32_t j = 0; j < m; j++) {
+        if (offset == 0) {
+            double d = a[j * m + j];
+            for (uint32_t k = 0; k < j; k++) d -= a[j * m + k] * a[j * m + k];
+            asm volatile("fsqrt.d %[d], %[d] \n" : [ d ] "+f"(d));
+            a[j * m + j] = d;
+        }
+        snrt_cluster_hw_barrier();
+
+        if (snrt_is_compute_core()) {
+            double inv = 1.0 / a[j * m + j];
+            for (uint32_t i = j + 1 + offset; i < m; i += stride) {
+                double acc = a[i * m + j];
+                for (uint32_t k = 0; k < j; k++)
+                    acc -= a[i * m + k] * a[j * m + k];
+                a[i * m + j] = acc * inv;
+            }
+        }
+        snrt_cluster_hw_barrier();
+    }
+}
+
+// Blocked right-looking Cholesky factorization on square tiles of size
+// m / m_tiles. For every column of tiles, cluster 0 factorizes the diagonal
+// tile, the tiles below it are solved against it with the TRSM tile kernel,
+// and the lower triangle of the trailing matrix is updated with the syrk
+// micro-kernel. The tiles of the last two steps are distributed round-robin
+// over the clusters, as in syrk_job(). Must be called by all cores in all
+// clusters.
+void potrf_job(potrf_args_t *args) {
+    uint32_t m = args->m;
+    uint32_t m_tiles = args->m_tiles;
+    uint32_t tile = m / m_tiles;
+    uint32_t tile_bytes = tile * tile * sizeof(double);
+    uint32_t cluster_idx = snrt_cluster_idx();
+    uint32_t num_clusters = snrt_cluster_num();
+
+    // Allocate space for the output tile and two operand tiles in TCDM
+    double *local_c = snrt_l1_alloc_cluster_local(tile_bytes, sizeof(double));
+    double *local_a = snrt_l1_alloc_cluster_local(tile_bytes, sizeof(double));
+    double *local_at = snrt_l1_alloc_cluster_local(tile_bytes, sizeof(double));
+
+    // The SSRs of the syrk micro-kernel may be configured for another shape
+    setup_ssr = 1;
+
+    for (uint32_t k = 0; k < m_tiles; k++) {
+        // L_kk = potrf(A_kk)
+        if (cluster_idx == 0) {
+            if (snrt_is_dm_core()) {
+                snrt_dma_load_2d_tile(local_c, args->a, k, k, tile, tile, m,
+                                      sizeof(double));
+                snrt_dma_wait_all();
+            }
+            snrt_cluster_hw_barrier();
+            potrf_tile(tile, local_c);
+            if (snrt_is_dm_core()) {
+                snrt_dma_store_2d_tile(args->a, local_c, k, k, tile, tile, m,
+                                       sizeof(double));
+                snrt_dma_wait_all();
+            }
+        }
+        snrt_global_barrier();
+
+        // L_ik = A_ik L_kk^-T
+        for (uint32_t i = k + 1 + cluster_idx; i < m_tiles; i += num_clusters) {
+            if (snrt_is_dm_core()) {
+                snrt_dma_load_2d_tile(local_a, args->a, k, k, tile, tile, m,
+                                      sizeof(double));
+                snrt_dma_load_2d_tile(local_c, args->a, i, k, tile, tile, m,
+                                      sizeof(double));
+                snrt_dma_wait_all();
+            }
+            snrt_cluster_hw_barrier();
+            if (snrt_is_compute_core()) trsm_tile(tile, local_a, local_c);
+            snrt_cluster_hw_barrier();
+            if (snrt_is_dm_core()) {
+                snrt_dma_store_2d_tile(args->a, local_c, i, k, tile, tile, m,
+                                       sizeof(double));
+                snrt_dma_wait_all();
+            }
+        }
+        snrt_global_barrier();
+
+        // A_ij -= L_ik L_jk^T, for the lower triangle of the trailing matrix
+        uint32_t trailing = m_tiles - k - 1;
+        uint32_t n_tiles = trailing * (trailing + 1) / 2;
+        for (uint32_t t = cluster_idx; t < n_tiles; t += num_clusters) {
+            uint32_t i, j;
+            syrk_tile_coords(t, &i, &j);
+            i += k + 1;
+            j += k + 1;
+
+            if (snrt_is_dm_core()) {
+                snrt_dma_load_2d_tile(local_c, args->a, i, j, tile, tile, m,
+                                      sizeof(double));
+                snrt_dma_load_2d_tile(local_a, args->a, i, k, tile, tile, m,
+                                      sizeof(double));
+                if (i != j)
+                    snrt_dma_load_2d_tile(local_at, args->a, j, k, tile, tile,
+                                          m, sizeof(double));
+                snrt_dma_wait_all();
+            }
+            snrt_cluster_hw_barrier();
+            if (snrt_is_compute_core())
+                syrk_opt(tile, tile, -1, local_a, i == j ? local_a : local_at,
+                         1, local_c);
+            snrt_cluster_hw_barrier();
+            if (snrt_is_dm_core()) {
+                snrt_dma_store_2d_tile(args->a, local_c, i, j, tile, tile, m,
+                                       sizeof(double));
+                snrt_dma_wait_all();
+            }
+        }
+        snrt_global_barrier();
+    }
+
+    snrt_l1_update_next_v2(local_c);
+    snrt_cluster_hw_barrier();
+}
@@ -0,0 +1,131 @@
+#!/usr/bin/env python3
+# Copyright 2024 ETH Zurich and University of Bologna.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+import numpy as np
+import sys
+
+import snitch.util.sim.data_utils as du
+
+
+class SparseDataGen(du.DataGen):
+
+    PATTERNS = ['uniform', 'banded', 'powerlaw']
+
+    def __init__(self):
+        self.rng = np.random.default_rng(seed=42)
+
+    def random_columns(self, n, nnz):
+        return np.sort(self.rng.choice(n, size=nnz, replace=False))
+
+    def generate_pattern(self, pattern, m, n, density):
+        """Return the sorted column indices of the nonzeros in every row."""
+        if pattern == 'uniform':
+            # Every element is nonzero with the same probability
+            return [np.flatnonzero(self.rng.random(n) < density) for _ in range(m)]
+        elif pattern == 'banded':
+            # Band around the diagonal, with the width giving the density
+            half_width = max(0, round(density * n / 2))
+            return [np.arange(max(0, i * n // m - half_width),
+                              min(n, i * n // m + half_width + 1)) for i in range(m)]
+        elif pattern == 'powerlaw':
+            # Row lengths follow a power law, as e.g. in graph adjacency
+            # matrices, so that few rows hold most nonzeros
+            weights = 1 / np.arange(1, m + 1) ** 1.5
+            lengths = np.minimum(np.rint(weights / weights.sum() * density * m * n), n)
+            lengths = self.rng.permutation(lengths.astype(int))
+            return [self.random_columns(n, length) for length in lengths]
+        raise ValueError(f'Unknown sparsity pattern {pattern}')
+
+    def generate_csr(self, pattern, m, n, density):
+        rows = self.generate_pattern(pattern, m, n, density)
+        row_ptr = np.concatenate(([0], np.cumsum([len(r) for r in rows]))).astype(np.uint32)
+        col_idx = np.concatenate(rows).astype(np.uint16)
+        val = du.generate_random_array(len(col_idx), seed=int(self.rng.integers(2**32)))
+        return row_ptr, col_idx, val
+
+    @staticmethod
+    def to_dense(row_ptr, col_idx, val, m, n):
+        a = np.zeros((m, n))
+        for i in range(m):
+            a[i, col_idx[row_ptr[i]:row_ptr[i + 1]]] = val[row_ptr[i]:row_ptr[i + 1]]
+        return a
+
+    def validate(self, **kwargs):
+        assert kwargs['n'] < 2**16, 'Column indices must fit in 16 bits'
+        assert all(p in self.PATTERNS for p in kwargs['patterns']), \
+            f'Sparsity patterns must be among {self.PATTERNS}'
+
+    def emit_header(self, **kwargs):
+        header = [super().emit_header()]
+
+        self.validate(**kwargs)
+
+        m, n, spmm_n, density = kwargs['m'], kwargs['n'], kwargs['spmm_n'], kwargs['density']
+        section = kwargs['section']
+
+        # Dense vector, dense matrix (stored transposed) and sparse vector
+        x = du.generate_random_array(n, seed=1)
+        b = du.generate_random_array((n, spmm_n), seed=2)
+        s_idx = self.random_columns(n, round(kwargs['vec_density'] * n)).astype(np.uint16)
+        s_val = du.generate_random_array(len(s_idx), seed=3)
+        s = np.zeros(n)
+        s[s_idx] = s_val
+
+        header += [du.format_scalar_definition('const uint32_t', 'spmm_n', spmm_n)]
+        header += [du.format_array_definition('double', 'x', x, section=section)]
+        header += [du.format_array_definition('double', 'bt', b.T.flatten(), section=section)]
+        header += [du.format_array_definition('uint16_t', 's_idx', s_idx, section=section)]
+        header += [du.format_array_definition('double', 's_val', s_val, section=section)]
+        header += [du.format_struct_definition('sparse_vec_t', 's', {
+            'n': n,
+            'nnz': len(s_idx),
+            'idx': 's_idx',
+            'val': 's_val'
+        })]
+
+        total_size = 0
+        for p in kwargs['patterns']:
+            row_ptr, col_idx, val = self.generate_csr(p, m, n, density)
+            a = self.to_dense(row_ptr, col_idx, val, m, n)
+
+            header += [du.format_array_definition('uint32_t', f'{p}_row_ptr', row_ptr,
+                                                  section=section)]
+            header += [du.format_array_definition('uint16_t', f'{p}_col_idx', col_idx,
+                                                  section=section)]
+            header += [du.format_array_definition('double', f'{p}_val', val, section=section)]
+            header += [du.format_struct_definition('sparse_csr_t', p, {
+                'm': m,
+                'n': n,
+                'nnz': len(col_idx),
+                'row_ptr': f'{p}_row_ptr',
+                'col_idx': f'{p}_col_idx',
+                'val': f'{p}_val'
+            })]
+            header += [du.format_array_definition('double', f'{p}_spmv', a @ x)]
+            header += [du.format_array_definition('double', f'{p}_spmm', (a @ b).flatten())]
+            header += [du.format_array_definition('double', f'{p}_spmspv', a @ s)]
+
+            # Matrices are copied to TCDM one after the other
+            total_size += row_ptr.nbytes + col_idx.nbytes + val.nbytes + (1 + spmm_n) * m * 8
+
+        total_size += x.nbytes + b.nbytes + s_idx.nbytes + s_val.nbytes
+        du.validate_tcdm_footprint(total_size)
+
+        patterns = kwargs['patterns']
+        header += [f'#define NUM_MATRICES {len(patterns)}']
+        header += [du.format_array_definition('sparse_csr_t *', 'matrices',
+                                              np.array([f'&{p}' for p in patterns]))]
+        header += [du.format_array_definition('const char *', 'names',
+                                              np.array([f'"{p}"' for p in patterns]))]
+        for kernel in ['spmv', 'spmm', 'spmspv']:
+            header += [du.format_array_definition(
+                'double *', f'golden_{kernel}', np.array([f'{p}_{kernel}' for p in patterns]))]
+        header = '\n\n'.join(header)
+
+        return header
+
+
+if __name__ == '__main__':
+    sys.exit(SparseDataGen().main())
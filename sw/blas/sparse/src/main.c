@@ -0,0 +1,114 @@
+// Copyright 2024 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+//
+// Benchmark of the sparse kernels on matrices with different sparsity
+// patterns. For every matrix, the SpMV, SpMM and SpMSpV kernels are run once
+// with the scalar baselines and once with the SSR implementations. The
+// cycles of both are reported, and both results are checked against the
+// golden model.
+
+#include <stdint.h>
+
+#include "sparse.h"
+
+#include "data.h"
+#include "snrt.h"
+
+#define TOLERANCE 1e-10
+
+static inline void *l1_copy(const void *src, size_t size) {
+    void *dst = snrt_l1_alloc_cluster_local(size, sizeof(double));
+    if (snrt_is_dm_core()) snrt_dma_start_1d(dst, (void *)src, size);
+    return dst;
+}
+
+static inline uint32_t check(const double *actual, const double *golden,
+                             uint32_t n) {
+    uint32_t errors = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        double diff = actual[i] - golden[i];
+        errors += diff > TOLERANCE || diff < -TOLERANCE;
+    }
+    return errors;
+}
+
+int main() {
+    if (snrt_cluster_idx() != 0) return 0;
+
+    uint32_t errors = 0;
+
+    // Dense and sparse operands, shared by all matrices
+    double *l1_x = l1_copy(x, sizeof(x));
+    double *l1_bt = l1_copy(bt, sizeof(bt));
+    sparse_vec_t l1_s = s;
+    l1_s.idx = l1_copy(s.idx, s.nnz * sizeof(uint16_t));
+    l1_s.val = l1_copy(s.val, s.nnz * sizeof(double));
+
+    for (uint32_t i = 0; i < NUM_MATRICES; i++) {
+        const sparse_csr_t *a = matrices[i];
+        uint32_t m = a->m;
+
+        sparse_csr_t l1_a = *a;
+        l1_a.row_ptr = l1_copy(a->row_ptr, (m + 1) * sizeof(uint32_t));
+        l1_a.col_idx = l1_copy(a->col_idx, a->nnz * sizeof(uint16_t));
+        l1_a.val = l1_copy(a->val, a->nnz * sizeof(double));
+        double *l1_y = snrt_l1_alloc_cluster_local(m * sizeof(double),
+                                                   sizeof(double));
+        double *l1_c = snrt_l1_alloc_cluster_local(m * spmm_n * sizeof(double),
+                                                   sizeof(double));
+        if (snrt_is_dm_core()) snrt_dma_wait_all();
+        snrt_cluster_hw_barrier();
+
+        // Every kernel is run twice, first as baseline then with SSRs
+        uint32_t cycles[3][2];
+        for (uint32_t ssr = 0; ssr < 2; ssr++) {
+            uint32_t start_cycle = snrt_mcycle();
+            if (snrt_is_compute_core()) {
+                if (ssr)
+                    spmv_csr(&l1_a, l1_x, l1_y);
+                else
+                    spmv_csr_baseline(&l1_a, l1_x, l1_y);
+            }
+            snrt_cluster_hw_barrier();
+            cycles[0][ssr] = snrt_mcycle() - start_cycle;
+            if (snrt_cluster_core_idx() == 0)
+                errors += check(l1_y, golden_spmv[i], m);
+
+            start_cycle = snrt_mcycle();
+            if (snrt_is_compute_core()) {
+                if (ssr)
+                    spmm_csr_dense(&l1_a, spmm_n, l1_bt, l1_c);
+                else
+                    spmm_csr_dense_baseline(&l1_a, spmm_n, l1_bt, l1_c);
+            }
+            snrt_cluster_hw_barrier();
+            cycles[1][ssr] = snrt_mcycle() - start_cycle;
+            if (snrt_cluster_core_idx() == 0)
+                errors += check(l1_c, golden_spmm[i], m * spmm_n);
+
+            start_cycle = snrt_mcycle();
+            if (snrt_is_compute_core()) {
+                if (ssr)
+                    spmspv_csr(&l1_a, &l1_s, l1_y);
+                else
+                    spmspv_csr_baseline(&l1_a, &l1_s, l1_y);
+            }
+            snrt_cluster_hw_barrier();
+            cycles[2][ssr] = snrt_mcycle() - start_cycle;
+            if (snrt_cluster_core_idx() == 0)
+                errors += check(l1_y, golden_spmspv[i], m);
+            snrt_cluster_hw_barrier();
+        }
+
+        if (snrt_cluster_core_idx() == 0) {
+            printf(
+                "[sparse] %s m=%u n=%u nnz=%u spmv=%u/%u spmm=%u/%u "
+                "spmspv=%u/%u\n",
+                names[i], m, a->n, a->nnz, cycles[0][0], cycles[0][1],
+                cycles[1][0], cycles[1][1], cycles[2][0], cycles[2][1]);
+        }
+    }
+
+    return errors;
+}
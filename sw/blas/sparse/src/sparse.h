@@ -0,0 +1,324 @@
+// Copyright 2024 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdint.h>
+
+#include "snrt.h"
+
+#pragma once
+
+// Sparse matrix in compressed sparse row (CSR) format. The column indices of
+// every row must be sorted, which is only required by the kernels using the
+// SSR intersector. 16-bit indices are sufficient for any matrix which fits
+// in TCDM, and make the index arrays cheaper to stream.
+typedef struct {
+    uint32_t m;
+    uint32_t n;
+    uint32_t nnz;
+    uint32_t *row_ptr;
+    uint16_t *col_idx;
+    double *val;
+} sparse_csr_t;
+
+// Sparse vector, or equivalently a single column of a matrix in compressed
+// sparse column (CSC) format, with sorted indices.
+typedef struct {
+    uint32_t n;
+    uint32_t nnz;
+    uint16_t *idx;
+    double *val;
+} sparse_vec_t;
+
+// Returns the first row of the `part`-th of `num_parts` row blocks of `a`,
+// chosen such that all blocks hold approximately the same number of
+// nonzeros. Rows are never split, so a single long row can still unbalance
+// the partitioning.
+static inline uint32_t sparse_row_split(const sparse_csr_t *a, uint32_t part,
+                                        uint32_t num_parts) {
+    if (part == 0) return 0;
+    if (part >= num_parts) return a->m;
+
+    // Binary search for the first row starting at or after the target
+    uint32_t target = a->nnz * part / num_parts;
+    uint32_t lo = 0, hi = a->m;
+    while (lo < hi) {
+        uint32_t mid = (lo + hi) / 2;
+        if (a->row_ptr[mid] < target)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+// Accumulates n products of the elements streamed by SSR 0 and 1. Four
+// partial sums, staggered by the FREP sequencer, hide the FMA latency.
+static inline double sparse_ssr_dot(uint32_t n) {
+    double acc;
+    asm volatile(
+        "fcvt.d.w ft4, zero \n"
+        "fcvt.d.w ft5, zero \n"
+        "fcvt.d.w ft6, zero \n"
+        "fcvt.d.w ft7, zero \n"
+        "frep.o %[n_frep], 1, 3, 0b1001 \n"
+        "fmadd.d ft4, ft0, ft1, ft4 \n"
+        "fadd.d ft4, ft4, ft5 \n"
+        "fadd.d ft6, ft6, ft7 \n"
+        "fadd.d %[acc], ft4, ft6 \n"
+        : [ acc ] "=f"(acc)
+        : [ n_frep ] "r"(n - 1)
+        : "ft0", "ft1", "ft2", "ft4", "ft5", "ft6", "ft7");
+    return acc;
+}
+
+// Same as `sparse_ssr_dot()`, but for as many products as the SSR
+// intersector streams. The stream-controlled FREP has no assembler
+// mnemonic, it is encoded as `frep.o t0, 1, 3, 0b1001` with bit 31 set.
+// The repetition count in t0 is only used to reset the stagger counter,
+// so it must be a multiple of the four partial sums.
+static inline double sparse_ssr_isect_dot() {
+    double acc;
+    register uint32_t rpt asm("t0") = 3;
+    asm volatile(
+        "fcvt.d.w ft4, zero \n"
+        "fcvt.d.w ft5, zero \n"
+        "fcvt.d.w ft6, zero \n"
+        "fcvt.d.w ft7, zero \n"
+        ".word 0x8002b98b \n"
+        "fmadd.d ft4, ft0, ft1, ft4 \n"
+        "fadd.d ft4, ft4, ft5 \n"
+        "fadd.d ft6, ft6, ft7 \n"
+        "fadd.d %[acc], ft4, ft6 \n"
+        : [ acc ] "=f"(acc)
+        : "r"(rpt)
+        : "ft0", "ft1", "ft2", "ft4", "ft5", "ft6", "ft7");
+    return acc;
+}
+
+//================================================================================
+// Single-core kernels, on rows [row_start, row_end) of the matrix
+//================================================================================
+
+static inline void sc_spmv_csr_baseline(const sparse_csr_t *a, const double *x,
+                                        double *y, uint32_t row_start,
+                                        uint32_t row_end) {
+    for (uint32_t i = row_start; i < row_end; i++) {
+        double acc = 0;
+        for (uint32_t k = a->row_ptr[i]; k < a->row_ptr[i + 1]; k++)
+            acc += a->val[k] * x[a->col_idx[k]];
+        y[i] = acc;
+    }
+}
+
+// SSR 0 streams the nonzeros and SSR 1 gathers the matching elements of x.
+// A single stream covers all rows, so the SSRs are only configured once.
+static inline void sc_spmv_csr_ssr(const sparse_csr_t *a, const double *x,
+                                   double *y, uint32_t row_start,
+                                   uint32_t row_end) {
+    uint32_t nz_start = a->row_ptr[row_start];
+    uint32_t nnz = a->row_ptr[row_end] - nz_start;
+
+    if (nnz) {
+        snrt_ssr_loop_1d(SNRT_SSR_DM0, nnz, sizeof(double));
+        snrt_ssr_loop_1d(SNRT_SSR_DM1, nnz, sizeof(double));
+        snrt_ssr_idx_cfg(SNRT_SSR_DM1, SNRT_SSR_IDX_U16, 0, 0);
+        snrt_ssr_idx_base(SNRT_SSR_DM1, (double *)x);
+        snrt_ssr_read(SNRT_SSR_DM0, SNRT_SSR_1D, &a->val[nz_start]);
+        snrt_ssr_read_indir(SNRT_SSR_DM1, &a->col_idx[nz_start]);
+        snrt_ssr_enable();
+    }
+
+    for (uint32_t i = row_start; i < row_end; i++) {
+        uint32_t len = a->row_ptr[i + 1] - a->row_ptr[i];
+        y[i] = len ? sparse_ssr_dot(len) : 0;
+    }
+
+    if (nnz) {
+        snrt_fpu_fence();
+        snrt_ssr_disable();
+    }
+}
+
+// B is stored transposed, i.e. as an n x a->n row-major matrix, so that
+// its columns can be gathered with the column indices of A.
+static inline void sc_spmm_csr_dense_baseline(const sparse_csr_t *a,
+                                              uint32_t n, const double *bt,
+                                              double *c, uint32_t row_start,
+                                              uint32_t row_end) {
+    for (uint32_t i = row_start; i < row_end; i++) {
+        for (uint32_t j = 0; j < n; j++) {
+            const double *bt_j = &bt[j * a->n];
+            double acc = 0;
+            for (uint32_t k = a->row_ptr[i]; k < a->row_ptr[i + 1]; k++)
+                acc += a->val[k] * bt_j[a->col_idx[k]];
+            c[i * n + j] = acc;
+        }
+    }
+}
+
+// Computes one column of C at a time, as an SpMV with the corresponding
+// column of B. Only the pointers are reprogrammed between columns.
+static inline void sc_spmm_csr_dense_ssr(const sparse_csr_t *a, uint32_t n,
+                                         const double *bt, double *c,
+                                         uint32_t row_start, uint32_t row_end) {
+    uint32_t nz_start = a->row_ptr[row_start];
+    uint32_t nnz = a->row_ptr[row_end] - nz_start;
+
+    if (!nnz) {
+        for (uint32_t i = row_start; i < row_end; i++)
+            for (uint32_t j = 0; j < n; j++) c[i * n + j] = 0;
+        return;
+    }
+
+    snrt_ssr_loop_1d(SNRT_SSR_DM0, nnz, sizeof(double));
+    snrt_ssr_loop_1d(SNRT_SSR_DM1, nnz, sizeof(double));
+    snrt_ssr_idx_cfg(SNRT_SSR_DM1, SNRT_SSR_IDX_U16, 0, 0);
+    snrt_ssr_enable();
+
+    for (uint32_t j = 0; j < n; j++) {
+        snrt_ssr_idx_base(SNRT_SSR_DM1, (double *)&bt[j * a->n]);
+        snrt_ssr_read(SNRT_SSR_DM0, SNRT_SSR_1D, &a->val[nz_start]);
+        snrt_ssr_read_indir(SNRT_SSR_DM1, &a->col_idx[nz_start]);
+        for (uint32_t i = row_start; i < row_end; i++) {
+            uint32_t len = a->row_ptr[i + 1] - a->row_ptr[i];
+            c[i * n + j] = len ? sparse_ssr_dot(len) : 0;
+        }
+    }
+
+    snrt_fpu_fence();
+    snrt_ssr_disable();
+}
+
+static inline double spvv_baseline(uint32_t nnz_a, const uint16_t *a_idx,
+                                   const double *a_val, uint32_t nnz_b,
+                                   const uint16_t *b_idx,
+                                   const double *b_val) {
+    double acc = 0;
+    uint32_t i = 0, j = 0;
+    while (i < nnz_a && j < nnz_b) {
+        if (a_idx[i] == b_idx[j])
+            acc += a_val[i++] * b_val[j++];
+        else if (a_idx[i] < b_idx[j])
+            i++;
+        else
+            j++;
+    }
+    return acc;
+}
+
+// Sparse-sparse dot product. The SSR intersector matches the indices of
+// the two vectors in hardware, and only streams the values of the
+// matching positions.
+static inline double spvv_ssr(uint32_t nnz_a, const uint16_t *a_idx,
+                              const double *a_val, uint32_t nnz_b,
+                              const uint16_t *b_idx, const double *b_val) {
+    if (!nnz_a || !nnz_b) return 0;
+
+    snrt_ssr_loop_1d(SNRT_SSR_DM0, nnz_a, sizeof(double));
+    snrt_ssr_loop_1d(SNRT_SSR_DM1, nnz_b, sizeof(double));
+    snrt_ssr_idx_cfg(SNRT_SSR_DM0, SNRT_SSR_IDX_U16, 0, 0);
+    snrt_ssr_idx_cfg(SNRT_SSR_DM1, SNRT_SSR_IDX_U16, 0, 0);
+    snrt_ssr_idx_base(SNRT_SSR_DM0, (double *)a_val);
+    snrt_ssr_idx_base(SNRT_SSR_DM1, (double *)b_val);
+    snrt_ssr_read_isect(SNRT_SSR_DM0, (uint16_t *)a_idx);
+    snrt_ssr_read_isect(SNRT_SSR_DM1, (uint16_t *)b_idx);
+    snrt_ssr_enable();
+    double acc = sparse_ssr_isect_dot();
+    snrt_fpu_fence();
+    snrt_ssr_disable();
+    return acc;
+}
+
+static inline void sc_spmspv_csr_baseline(const sparse_csr_t *a,
+                                          const sparse_vec_t *x, double *y,
+                                          uint32_t row_start,
+                                          uint32_t row_end) {
+    for (uint32_t i = row_start; i < row_end; i++) {
+        uint32_t k = a->row_ptr[i];
+        y[i] = spvv_baseline(a->row_ptr[i + 1] - k, &a->col_idx[k],
+                             &a->val[k], x->nnz, x->idx, x->val);
+    }
+}
+
+// Every row is intersected with x. The stream of x is only restarted
+// between rows, its shape and base are programmed once.
+static inline void sc_spmspv_csr_ssr(const sparse_csr_t *a,
+                                     const sparse_vec_t *x, double *y,
+                                     uint32_t row_start, uint32_t row_end) {
+    if (!x->nnz) {
+        for (uint32_t i = row_start; i < row_end; i++) y[i] = 0;
+        return;
+    }
+
+    snrt_ssr_loop_1d(SNRT_SSR_DM1, x->nnz, sizeof(double));
+    snrt_ssr_idx_cfg(SNRT_SSR_DM0, SNRT_SSR_IDX_U16, 0, 0);
+    snrt_ssr_idx_cfg(SNRT_SSR_DM1, SNRT_SSR_IDX_U16, 0, 0);
+    snrt_ssr_idx_base(SNRT_SSR_DM1, x->val);
+    snrt_ssr_enable();
+
+    for (uint32_t i = row_start; i < row_end; i++) {
+        uint32_t k = a->row_ptr[i];
+        uint32_t len = a->row_ptr[i + 1] - k;
+        if (len) {
+            snrt_ssr_loop_1d(SNRT_SSR_DM0, len, sizeof(double));
+            snrt_ssr_idx_base(SNRT_SSR_DM0, &a->val[k]);
+            snrt_ssr_read_isect(SNRT_SSR_DM0, &a->col_idx[k]);
+            snrt_ssr_read_isect(SNRT_SSR_DM1, x->idx);
+            y[i] = sparse_ssr_isect_dot();
+        } else {
+            y[i] = 0;
+        }
+    }
+
+    snrt_fpu_fence();
+    snrt_ssr_disable();
+}
+
+//================================================================================
+// Multi-core kernels, to be called by all compute cores in the cluster
+//================================================================================
+
+// Every core computes a block of rows with the same number of nonzeros,
+// see `sparse_row_split()`. All operands are expected in TCDM.
+#define SPARSE_ROW_PARALLEL(a, kernel, ...)                                 \
+    do {                                                                   \
+        uint32_t core_idx = snrt_cluster_core_idx();                       \
+        uint32_t num_cores = snrt_cluster_compute_core_num();              \
+        uint32_t row_start = sparse_row_split(a, core_idx, num_cores);     \
+        uint32_t row_end = sparse_row_split(a, core_idx + 1, num_cores);   \
+        if (row_end > row_start) kernel(__VA_ARGS__, row_start, row_end); \
+    } while (0)
+
+// y = A * x
+static inline void spmv_csr(const sparse_csr_t *a, const double *x,
+                            double *y) {
+    SPARSE_ROW_PARALLEL(a, sc_spmv_csr_ssr, a, x, y);
+}
+
+static inline void spmv_csr_baseline(const sparse_csr_t *a, const double *x,
+                                     double *y) {
+    SPARSE_ROW_PARALLEL(a, sc_spmv_csr_baseline, a, x, y);
+}
+
+// C = A * B, with C an a->m x n row-major matrix and B transposed
+static inline void spmm_csr_dense(const sparse_csr_t *a, uint32_t n,
+                                  const double *bt, double *c) {
+    SPARSE_ROW_PARALLEL(a, sc_spmm_csr_dense_ssr, a, n, bt, c);
+}
+
+static inline void spmm_csr_dense_baseline(const sparse_csr_t *a, uint32_t n,
+                                           const double *bt, double *c) {
+    SPARSE_ROW_PARALLEL(a, sc_spmm_csr_dense_baseline, a, n, bt, c);
+}
+
+// y = A * x, with x sparse
+static inline void spmspv_csr(const sparse_csr_t *a, const sparse_vec_t *x,
+                              double *y) {
+    SPARSE_ROW_PARALLEL(a, sc_spmspv_csr_ssr, a, x, y);
+}
+
+static inline void spmspv_csr_baseline(const sparse_csr_t *a,
+                                       const sparse_vec_t *x, double *y) {
+    SPARSE_ROW_PARALLEL(a, sc_spmspv_csr_baseline, a, x, y);
+}
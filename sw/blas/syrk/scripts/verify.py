@@ -30,18 +30,23 @@ class SyrkVerifier(Verifier):
         }
         self.func_args = self.get_input_from_symbol('args', self.func_args)
 
+    # Only the lower triangle of C is computed
+    def lower_triangle(self, C):
+        m = self.func_args['m']
+        return np.reshape(C, (m, m))[np.tril_indices(m)]
+
     def get_actual_results(self):
-        return self.get_output_from_symbol(self.OUTPUT_UIDS[0], 'double')
+        return self.lower_triangle(self.get_output_from_symbol(self.OUTPUT_UIDS[0], 'double'))
 
     def get_expected_results(self):
         A = self.get_input_from_symbol('A', 'double')
         C = self.get_input_from_symbol('C', 'double')
         A = np.reshape(A, (self.func_args['m'], self.func_args['n']))
         C = np.reshape(C, (self.func_args['m'], self.func_args['m']))
-        return SyrkDataGen().golden_model(
+        return self.lower_triangle(SyrkDataGen().golden_model(
             self.func_args['alpha'], A,
             self.func_args['beta'], C
-        ).flatten()
+        ))
 
     def check_results(self, *args):
         return super().check_results(*args, rtol=1e-10)
@@ -4,6 +4,8 @@
 //
 // Author: Luca Colagrande <colluca@iis.ee.ethz.ch>
 
+#pragma once
+
 #include "args.h"
 #include "snrt.h"
 
@@ -173,6 +175,22 @@ void syrk_opt(uint32_t m, uint32_t n, double alpha, double *a, double *at,
     snrt_fpu_fence();
 }
 
+// Returns the coordinates of the t-th tile in the lower triangle of a
+// matrix of tiles, where tiles are enumerated row by row.
+static inline void syrk_tile_coords(uint32_t t, uint32_t *row, uint32_t *col) {
+    uint32_t r = 0;
+    while (t > r) {
+        t -= r + 1;
+        r++;
+    }
+    *row = r;
+    *col = t;
+}
+
+// Only the tiles in the lower triangle of C are computed, the tiles in the
+// strictly upper triangle are left untouched. The tiles are distributed
+// round-robin over the clusters, which balances them to within one tile.
+// On the diagonal the two operand tiles coincide, so only one is loaded.
 void syrk_job(syrk_args_t *args) {
     uint32_t m_frac, a_tile_size, a_tile_bytes, c_tile_size, c_tile_bytes;
     uint64_t local_a0_addr, local_at0_addr, local_c0_addr, local_a1_addr,
@@ -180,8 +198,10 @@ void syrk_job(syrk_args_t *args) {
     double *local_a[2];
     double *local_at[2];
     double *local_c[2];
-    uint32_t n_tiles, iterations;
+    uint32_t n_tiles, n_local_tiles, iterations;
     uint32_t i, i_dma_in, i_compute, i_dma_out, i_row, i_col, buff_idx;
+    uint32_t cluster_idx = snrt_cluster_idx();
+    uint32_t num_clusters = snrt_cluster_num();
 
 #ifndef JOB_ARGS_PRELOADED
     // Allocate space for job arguments in TCDM
@@ -219,8 +239,9 @@ void syrk_job(syrk_args_t *args) {
     local_c[1] = (double *)local_c1_addr;
 
     // Calculate number of iterations
-    n_tiles = args->m_tiles * args->m_tiles;
-    iterations = n_tiles + 2;
+    n_tiles = args->m_tiles * (args->m_tiles + 1) / 2;
+    n_local_tiles = (n_tiles + num_clusters - 1 - cluster_idx) / num_clusters;
+    iterations = n_local_tiles + 2;
 
     // Iterate over all tiles
     for (i = 0; i < iterations; i++) {
@@ -233,8 +254,8 @@ void syrk_job(syrk_args_t *args) {
                 // Compute tile and buffer indices
                 i_dma_out = i - 2;
                 buff_idx = i_dma_out % 2;
-                i_row = i_dma_out / args->m_tiles;
-                i_col = i_dma_out % args->m_tiles;
+                syrk_tile_coords(cluster_idx + i_dma_out * num_clusters,
+                                 &i_row, &i_col);
 
                 // Copy job outputs from TCDM
                 snrt_dma_store_2d_tile(args->c, local_c[buff_idx], i_row, i_col,
@@ -245,20 +266,21 @@ void syrk_job(syrk_args_t *args) {
             }
 
             // DMA in
-            if (i < n_tiles) {
+            if (i < n_local_tiles) {
                 snrt_mcycle();
 
                 // Compute tile and buffer indices
                 i_dma_in = i;
                 buff_idx = i_dma_in % 2;
-                i_row = i_dma_in / args->m_tiles;
-                i_col = i_dma_in % args->m_tiles;
+                syrk_tile_coords(cluster_idx + i_dma_in * num_clusters, &i_row,
+                                 &i_col);
 
                 // Copy job operands in TCDM
                 snrt_dma_load_1d_tile(local_a[buff_idx], args->a, i_row,
                                       a_tile_size, sizeof(double));
-                snrt_dma_load_1d_tile(local_at[buff_idx], args->a, i_col,
-                                      a_tile_size, sizeof(double));
+                if (i_row != i_col)
+                    snrt_dma_load_1d_tile(local_at[buff_idx], args->a, i_col,
+                                          a_tile_size, sizeof(double));
                 if (args->funcptr == syrk_opt || args->beta != 0) {
                     snrt_dma_load_2d_tile(local_c[buff_idx], args->c, i_row,
                                           i_col, m_frac, m_frac, args->m,
@@ -272,17 +294,20 @@ void syrk_job(syrk_args_t *args) {
 
         // Compute
         if (snrt_is_compute_core()) {
-            if (i > 0 && i < (n_tiles + 1)) {
+            if (i > 0 && i < (n_local_tiles + 1)) {
                 snrt_mcycle();
 
                 // Compute tile and buffer indices
                 i_compute = i - 1;
                 buff_idx = i_compute % 2;
+                syrk_tile_coords(cluster_idx + i_compute * num_clusters,
+                                 &i_row, &i_col);
 
                 // Perform tile computation
                 syrk_fp_t fp = args->funcptr;
                 fp(m_frac, args->n, args->alpha, local_a[buff_idx],
-                   local_at[buff_idx], args->beta, local_c[buff_idx]);
+                   i_row == i_col ? local_a[buff_idx] : local_at[buff_idx],
+                   args->beta, local_c[buff_idx]);
 
                 snrt_mcycle();
             }
@@ -0,0 +1,59 @@
+#!/usr/bin/env python3
+# Copyright 2024 ETH Zurich and University of Bologna.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+import numpy as np
+
+import snitch.util.sim.data_utils as du
+
+
+class TrsmDataGen(du.DataGen):
+
+    def golden_model(self, L, B):
+        # X L^T = B <=> L X^T = B^T
+        return np.linalg.solve(L, B.transpose()).transpose()
+
+    def validate(self, **kwargs):
+        n_cores = 8
+        assert (kwargs['n'] % kwargs['n_tiles']) == 0, "n must be an integer multiple of n_tiles"
+        tile = kwargs['n'] // kwargs['n_tiles']
+        assert (kwargs['m'] % tile) == 0, "m must be an integer multiple of the tile size"
+        assert (tile % n_cores) == 0, "tile size must be an integer multiple of the number of cores"
+        assert (tile % 4) == 0, "tile size must be an integer multiple of the unroll factor 4"
+
+        # Tiles of B, X and L
+        du.validate_tcdm_footprint(3 * tile * tile * 8)
+
+    def emit_header(self, **kwargs):
+        header = [super().emit_header()]
+
+        self.validate(**kwargs)
+
+        m, n = kwargs['m'], kwargs['n']
+
+        # Make L diagonally dominant, to keep the system well conditioned
+        L = np.tril(du.generate_random_array((n, n))) + n * np.eye(n)
+        B = du.generate_random_array((m, n))
+
+        L_uid = 'L'
+        B_uid = 'B'
+
+        cfg = {
+            'm': m,
+            'n': n,
+            'n_tiles': kwargs['n_tiles'],
+            'l': L_uid,
+            'b': B_uid
+        }
+
+        header += [du.format_array_definition('double', L_uid, L.flatten())]
+        header += [du.format_array_definition('double', B_uid, B.flatten())]
+        header += [du.format_struct_definition('trsm_args_t', 'args', cfg)]
+        header = '\n\n'.join(header)
+
+        return header
+
+
+if __name__ == '__main__':
+    TrsmDataGen().main()
@@ -0,0 +1,42 @@
+#!/usr/bin/env python3
+# Copyright 2024 ETH Zurich and University of Bologna.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+import numpy as np
+import sys
+from datagen import TrsmDataGen
+
+from snitch.util.sim.verif_utils import Verifier
+
+
+class TrsmVerifier(Verifier):
+
+    OUTPUT_UIDS = ['B']
+
+    def __init__(self):
+        super().__init__()
+        self.func_args = {
+            'm': 'I',
+            'n': 'I',
+            'n_tiles': 'I',
+            'L': 'I',
+            'B': 'I'
+        }
+        self.func_args = self.get_input_from_symbol('args', self.func_args)
+
+    def get_actual_results(self):
+        return self.get_output_from_symbol(self.OUTPUT_UIDS[0], 'double')
+
+    def get_expected_results(self):
+        m, n = self.func_args['m'], self.func_args['n']
+        L = np.reshape(self.get_input_from_symbol('L', 'double'), (n, n))
+        B = np.reshape(self.get_input_from_symbol('B', 'double'), (m, n))
+        return TrsmDataGen().golden_model(L, B).flatten()
+
+    def check_results(self, *args):
+        return super().check_results(*args, atol=1e-10)
+
+
+if __name__ == "__main__":
+    sys.exit(TrsmVerifier().main())
@@ -0,0 +1,103 @@
+// Copyright 2024 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <stdint.h>
+
+#include "snrt.h"
+#include "syrk/src/syrk.h"
+
+// Solves X L^T = B for X, where L is a lower triangular n x n matrix and B
+// an m x n matrix, both stored in row-major order. X overwrites B.
+typedef struct {
+    uint32_t m;
+    uint32_t n;
+    uint32_t n_tiles;
+    double *l;
+    double *b;
+} trsm_args_t;
+
+// Solves X L^T = B on m x m tiles, stored densely. X overwrites B. Every row
+// of X is computed independently by forward substitution, so the rows are
+// distributed over the compute cores. The substitution proceeds column by
+// column over all of a core's rows, so that every core divides only once per
+// column.
+static inline void trsm_tile(uint32_t m, double *l, double *b) {
+    uint32_t offset = snrt_cluster_core_idx();
+    uint32_t stride = snrt_cluster_compute_core_num();
+
+    for (uint32_t j = 0; j < m; j++) {
+        double inv = 1.0 / l[j * m + j];
+        for (uint32_t i = offset; i < m; i += stride) {
+            double *x = &b[i * m];
+            double acc = x[j];
+            for (uint32_t k = 0; k < j; k++) acc -= l[j * m + k] * x[k];
+            x[j] = acc * inv;
+        }
+    }
+}
+
+// Blocked TRSM on square tiles of size n / n_tiles, which must also divide m.
+// The row blocks of B are independent and are distributed round-robin over
+// the clusters. Every tile of a row block is computed left-looking: the
+// contributions of the tiles to its left, which are already solved, are
+// subtracted with the syrk micro-kernel, then the tile is solved against the
+// diagonal tile of L. Must be called by all cores in all clusters.
+void trsm_job(trsm_args_t *args) {
+    uint32_t tile = args->n / args->n_tiles;
+    uint32_t tile_bytes = tile * tile * sizeof(double);
+    uint32_t m_tiles = args->m / tile;
+    uint32_t n_tiles = args->n_tiles;
+
+    // Allocate space for the tiles of B, X and L in TCDM
+    double *local_b = snrt_l1_alloc_cluster_local(tile_bytes, sizeof(double));
+    double *local_x = snrt_l1_alloc_cluster_local(tile_bytes, sizeof(double));
+    double *local_l = snrt_l1_alloc_cluster_local(tile_bytes, sizeof(double));
+
+    // The SSRs of the syrk micro-kernel may be configured for another shape
+    setup_ssr = 1;
+
+    for (uint32_t i = snrt_cluster_idx(); i < m_tiles;
+         i += snrt_cluster_num()) {
+        for (uint32_t j = 0; j < n_tiles; j++) {
+            if (snrt_is_dm_core())
+                snrt_dma_load_2d_tile(local_b, args->b, i, j, tile, tile,
+                                      args->n, sizeof(double));
+
+            // B_ij -= X_ik L_jk^T
+            for (uint32_t k = 0; k < j; k++) {
+                if (snrt_is_dm_core()) {
+                    snrt_dma_load_2d_tile(local_x, args->b, i, k, tile, tile,
+                                          args->n, sizeof(double));
+                    snrt_dma_load_2d_tile(local_l, args->l, j, k, tile, tile,
+                                          args->n, sizeof(double));
+                    snrt_dma_wait_all();
+                }
+                snrt_cluster_hw_barrier();
+                if (snrt_is_compute_core())
+                    syrk_opt(tile, tile, -1, local_x, local_l, 1, local_b);
+                snrt_cluster_hw_barrier();
+            }
+
+            // X_ij = B_ij L_jj^-T
+            if (snrt_is_dm_core()) {
+                snrt_dma_load_2d_tile(local_l, args->l, j, j, tile, tile,
+                                      args->n, sizeof(double));
+                snrt_dma_wait_all();
+            }
+            snrt_cluster_hw_barrier();
+            if (snrt_is_compute_core()) trsm_tile(tile, local_l, local_b);
+            snrt_cluster_hw_barrier();
+            if (snrt_is_dm_core()) {
+                snrt_dma_store_2d_tile(args->b, local_b, i, j, tile, tile,
+                                       args->n, sizeof(double));
+                snrt_dma_wait_all();
+            }
+        }
+    }
+
+    snrt_l1_update_next_v2(local_b);
+    snrt_cluster_hw_barrier();
+}
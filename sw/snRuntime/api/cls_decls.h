@@ -7,10 +7,19 @@
 #include <stdint.h>
 
 #include "alloc_decls.h"
+#include "perf_cnt_decls.h"
 
 typedef struct {
     uint32_t hw_barrier;
     snrt_allocator_t l1_allocator;
+    // Flags used by the DMA-based global reduction (see sync.h)
+    volatile uint32_t reduction_cts;
+    volatile uint32_t reduction_seq;
+    // Flags used by the ring-based collectives (see sync.h)
+    volatile uint32_t ring_cts;
+    volatile uint32_t ring_seq;
+    // Per-region totals of the region profiler (see perf_cnt.h)
+    snrt_perf_profile_t perf;
 } cls_t;
 
 inline cls_t* cls();
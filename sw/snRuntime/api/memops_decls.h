@@ -0,0 +1,25 @@
+// Copyright 2023 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Defined in ssr.h
+inline void snrt_fpu_fence();
+
+inline void snrt_memcpy_cpu(void *dst, const void *src, size_t n);
+
+inline void snrt_memset_cpu(void *ptr, int value, size_t n);
+
+inline int snrt_memops_dma_available();
+
+inline void snrt_memcpy_dma(void *dst, const void *src, size_t n);
+
+inline void snrt_memset_dma(void *ptr, int value, size_t n);
+
+inline void *snrt_memcpy(void *dst, const void *src, size_t n);
+
+inline void *snrt_memset(void *ptr, int value, size_t num);
@@ -0,0 +1,44 @@
+// Copyright 2023 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <stdint.h>
+
+// Maximum number of distinct regions tracked by the region profiler
+#define SNRT_PERF_MAX_REGIONS 8
+// Maximum number of metrics tracked simultaneously by the region profiler
+#define SNRT_PERF_MAX_METRICS 8
+
+typedef struct {
+    // Number of times the region was entered and exited
+    uint32_t count;
+    // Counter snapshot taken on the last region entry
+    uint32_t start[SNRT_PERF_MAX_METRICS];
+    // Accumulated counter deltas over all region instances
+    uint32_t total[SNRT_PERF_MAX_METRICS];
+} snrt_perf_region_t;
+
+typedef struct {
+    // Number of configured metrics, zero if the profiler is unconfigured
+    volatile uint32_t num_metrics;
+    // Counter selection (metric and hart) of every configured metric
+    uint32_t metrics[SNRT_PERF_MAX_METRICS];
+    snrt_perf_region_t regions[SNRT_PERF_MAX_REGIONS];
+    // Number of DMA channels tracked by the DMA statistics
+    volatile uint32_t dma_num_channels;
+    // Cycle at which the DMA statistics were started
+    uint32_t dma_start_cycle;
+} snrt_perf_profile_t;
+
+typedef struct {
+    // Bytes written by the channel
+    uint32_t bytes;
+    // AXI write bursts issued by the channel
+    uint32_t bursts;
+    // Cycles in which the channel was busy
+    uint32_t busy;
+    // Cycles elapsed since the statistics were started
+    uint32_t cycles;
+} snrt_dma_stats_t;
@@ -11,9 +11,32 @@ typedef struct {
     uint32_t volatile iteration;
 } snrt_barrier_t;
 
+typedef struct {
+    uint32_t volatile next;     // Next ticket to be handed out
+    uint32_t volatile serving;  // Ticket currently holding the lock
+} snrt_ticket_lock_t;
+
+typedef struct snrt_mcs_node {
+    struct snrt_mcs_node *volatile next;
+    uint32_t volatile locked;
+} snrt_mcs_node_t;
+
+typedef struct {
+    snrt_mcs_node_t *volatile tail;
+} snrt_mcs_lock_t;
+
+typedef enum {
+    SNRT_REDUCTION_SUM,
+    SNRT_REDUCTION_MAX,
+    SNRT_REDUCTION_MIN
+} snrt_reduction_op_t;
+
 extern volatile uint32_t _snrt_mutex;
 extern volatile snrt_barrier_t _snrt_barrier;
 extern volatile uint32_t _reduction_result;
+extern __thread uint32_t _snrt_reduction_chunks;
+extern __thread uint32_t _snrt_ring_chunks;
+extern __thread snrt_mcs_node_t _snrt_mcs_node;
 
 inline volatile uint32_t *snrt_mutex();
 
@@ -23,6 +46,14 @@ inline void snrt_mutex_ttas_acquire(volatile uint32_t *pmtx);
 
 inline void snrt_mutex_release(volatile uint32_t *pmtx);
 
+inline void snrt_ticket_lock_acquire(snrt_ticket_lock_t *lock);
+
+inline void snrt_ticket_lock_release(snrt_ticket_lock_t *lock);
+
+inline void snrt_mcs_lock_acquire(snrt_mcs_lock_t *lock);
+
+inline void snrt_mcs_lock_release(snrt_mcs_lock_t *lock);
+
 inline void snrt_cluster_hw_barrier();
 
 inline void snrt_global_barrier();
@@ -5,20 +5,28 @@
 __thread volatile dm_t *dm_p;
 volatile dm_t *volatile dm_p_global;
 
+extern void poke_dm(void);
+
 extern void dm_init(void);
 
 extern void dm_main(void);
 
-extern void dm_memcpy_async(void *dest, const void *src, size_t n);
+extern volatile dm_slot_t *dm_reserve_slot(uint32_t *ticket);
+
+extern void dm_publish_slot(volatile dm_slot_t *slot, uint32_t ticket);
 
-extern void dm_memcpy2d_async(uint64_t src, uint64_t dst, uint32_t size,
-                              uint32_t sstrd, uint32_t dstrd, uint32_t nreps,
-                              uint32_t cfg);
+extern dm_txid_t dm_memcpy_async(void *dest, const void *src, size_t n);
+
+extern dm_txid_t dm_memcpy2d_async(uint64_t src, uint64_t dst, uint32_t size,
+                                   uint32_t sstrd, uint32_t dstrd,
+                                   uint32_t nreps, uint32_t cfg);
 
 extern void dm_start(void);
 
 extern void dm_wait(void);
 
+extern void dm_wait_txid(dm_txid_t txid);
+
 extern void dm_exit(void);
 
 extern void dm_wait_ready(void);
\ No newline at end of file
@@ -21,10 +21,10 @@
 
 /**
  * @brief Number of outstanding transactions to buffer. Each requires
- * sizeof(dm_task_t) bytes
+ * sizeof(dm_slot_t) bytes. Must be a power of two.
  *
  */
-#define DM_TASK_QUEUE_SIZE 4
+#define DM_TASK_QUEUE_SIZE 8
 
 //================================================================================
 // Macros
@@ -76,6 +76,21 @@ typedef struct {
     uint32_t twod;
 } dm_task_t;
 
+// A slot of the task queue. The sequence number implements a lock-free
+// multi-producer single-consumer ring: slot `t % DM_TASK_QUEUE_SIZE` can be
+// written by the producer holding ticket `t` when `seq == t`, and is ready to
+// be consumed when `seq == t + 1`. After consuming it, the DM core sets
+// `seq = t + DM_TASK_QUEUE_SIZE`, handing it to the producer of the next lap.
+typedef struct {
+    dm_task_t task;
+    volatile uint32_t seq;
+} dm_slot_t;
+
+// Handle of a queued task. The DM core issues tasks in ticket order, one DMA
+// transfer each, so the handle maps 1:1 to the hardware transfer ID it
+// obtains: txid = handle + txid_offset.
+typedef uint32_t dm_txid_t;
+
 // used for ultra-fine grained communication
 // stat_q can be used to request a command, 0 is no command
 // the response is put into stat_p and is valid iff stat_pvalid is non-zero
@@ -89,15 +104,22 @@ typedef enum en_stat {
 } en_stat_t;
 
 typedef struct {
-    dm_task_t queue[DM_TASK_QUEUE_SIZE];
-    uint32_t queue_back;
-    uint32_t queue_front;
-    volatile uint32_t queue_fill;
+    dm_slot_t queue[DM_TASK_QUEUE_SIZE];
+    // next ticket to be consumed, only written by the DM core
+    volatile uint32_t queue_back;
+    // next ticket to be handed to a producer
+    volatile uint32_t queue_front;
+    // set by the first producer that wakes the DM core, until it wakes up
+    volatile uint32_t doorbell;
     volatile uint32_t mutex;
     volatile en_stat_t stat_q;
     volatile uint32_t stat_p;
     volatile uint32_t stat_pvalid;
     volatile uint32_t dm_wfi;
+    // hardware transfer ID of the task with ticket 0
+    volatile uint32_t txid_offset;
+    // last hardware transfer ID known to have completed
+    volatile uint32_t completed_txid;
 } dm_t;
 
 //================================================================================
@@ -134,8 +156,13 @@ inline void wfi_dm(uint32_t cluster_core_idx) {
     snrt_wfi();
     snrt_int_cluster_clr(1 << cluster_core_idx);
     __atomic_add_fetch(&dm_p->dm_wfi, -1, __ATOMIC_RELAXED);
+    // re-arm the doorbell before looking at the queue again
+    __atomic_store_n(&dm_p->doorbell, 0, __ATOMIC_RELAXED);
 }
 inline void wake_dm(void) {
+    // only the first core to ring the doorbell since the DM last woke up has
+    // to send the wakeup, all other requests are batched with it
+    if (__atomic_exchange_n(&dm_p->doorbell, 1, __ATOMIC_RELAXED)) return;
     // wait for DM to sleep before sending wakeup
     while (!__atomic_load_n(&dm_p->dm_wfi, __ATOMIC_RELAXED))
         ;
@@ -143,6 +170,17 @@ inline void wake_dm(void) {
 }
 #endif  // #ifdef DM_USE_GLOBAL_CLINT
 
+/**
+ * @brief Wake the DM core if it is asleep, without blocking if it is not
+ * @details Must be polled, as the DM core could be about to go to sleep
+ */
+inline void poke_dm(void) {
+#ifndef DM_USE_GLOBAL_CLINT
+    if (!__atomic_load_n(&dm_p->dm_wfi, __ATOMIC_RELAXED)) return;
+#endif
+    wake_dm();
+}
+
 /**
  * @brief Init the data mover and load a pointer to the DM struct in to TLS.
  * Needs to be called by the DM itself and all harts that want to use the dm
@@ -159,6 +197,8 @@ inline void dm_init(void) {
 #endif
         dm_p = (dm_t *)snrt_l1_alloc(sizeof(dm_t));
         snrt_memset((void *)dm_p, 0, sizeof(dm_t));
+        for (uint32_t i = 0; i < DM_TASK_QUEUE_SIZE; i++)
+            dm_p->queue[i].seq = i;
         dm_p_global = dm_p;
     } else {
         while (!dm_p_global)
@@ -172,33 +212,46 @@ inline void dm_init(void) {
  * @details
  */
 inline void dm_main(void) {
+    volatile dm_slot_t *slot;
     volatile dm_task_t *t;
     uint32_t do_exit = 0;
     uint32_t cluster_core_idx = snrt_cluster_core_idx();
+    uint32_t back = dm_p->queue_back;
+    uint32_t txid, last_txid;
+
+    last_txid = __builtin_sdma_stat(DM_STATUS_COMPLETE_ID);
+    dm_p->completed_txid = last_txid;
 
     DM_PRINTF(10, "enter main\n");
 
     while (!do_exit) {
+        slot = &dm_p->queue[back % DM_TASK_QUEUE_SIZE];
+
         /// New transaction to issue?
-        if (dm_p->queue_fill) {
+        if (slot->seq == back + 1) {
             // wait until DMA is ready
             while (__builtin_sdma_stat(DM_STATUS_WOULD_BLOCK))
                 ;
 
-            t = &dm_p->queue[dm_p->queue_back];
+            t = &slot->task;
 
             if (t->twod) {
                 DM_PRINTF(10, "start twod\n");
-                __builtin_sdma_start_twod(t->src, t->dst, t->size, t->sstrd,
-                                          t->dstrd, t->nreps, t->cfg);
+                txid = __builtin_sdma_start_twod(t->src, t->dst, t->size,
+                                                 t->sstrd, t->dstrd, t->nreps,
+                                                 t->cfg);
             } else {
                 DM_PRINTF(10, "start oned\n");
-                __builtin_sdma_start_oned(t->src, t->dst, t->size, t->cfg);
+                txid = __builtin_sdma_start_oned(t->src, t->dst, t->size,
+                                                 t->cfg);
             }
+            dm_p->txid_offset = txid - back;
+            last_txid = txid;
 
-            // bump
-            dm_p->queue_back = (dm_p->queue_back + 1) % DM_TASK_QUEUE_SIZE;
-            __atomic_add_fetch(&dm_p->queue_fill, -1, __ATOMIC_RELAXED);
+            // release the slot to the producer of the next lap and bump
+            slot->seq = back + DM_TASK_QUEUE_SIZE;
+            dm_p->queue_back = ++back;
+            continue;
         }
 
         /// any STAT request pending?
@@ -224,8 +277,13 @@ inline void dm_main(void) {
             }
         }
 
-        // sleep if queue is empty and no stats pending
-        if (!dm_p->queue_fill && !dm_p->stat_q) {
+        /// publish completed transfers for dm_wait_txid
+        dm_p->completed_txid = __builtin_sdma_stat(DM_STATUS_COMPLETE_ID);
+
+        // sleep if queue is empty, no stats pending and all issued transfers
+        // completed
+        if (slot->seq != back + 1 && !dm_p->stat_q &&
+            (int32_t)(dm_p->completed_txid - last_txid) >= 0) {
             wfi_dm(cluster_core_idx);
         }
     }
@@ -248,9 +306,42 @@ inline void dm_exit(void) {
     wake_dm();
 }
 
+/**
+ * @brief Reserve a slot in the task queue
+ * @details Draws a ticket with a single atomic add, then blocks until the
+ * slot associated to the ticket has been released by the DM core, i.e. only
+ * if the DM queue is full. Every producer spins on its own slot, no lock is
+ * taken.
+ *
+ * @param ticket pointer where the ticket is returned
+ * @return pointer to the reserved slot
+ */
+inline volatile dm_slot_t *dm_reserve_slot(uint32_t *ticket) {
+    uint32_t t = __atomic_fetch_add(&dm_p->queue_front, 1, __ATOMIC_RELAXED);
+    volatile dm_slot_t *slot = &dm_p->queue[t % DM_TASK_QUEUE_SIZE];
+    // a full queue flushes the batch queued so far
+    if (slot->seq != t) {
+        wake_dm();
+        while (slot->seq != t)
+            ;
+    }
+    *ticket = t;
+    return slot;
+}
+
+/**
+ * @brief Hand a filled slot over to the DM core
+ *
+ * @param slot pointer to the slot returned by dm_reserve_slot
+ * @param ticket ticket returned by dm_reserve_slot
+ */
+inline void dm_publish_slot(volatile dm_slot_t *slot, uint32_t ticket) {
+    __atomic_store_n(&slot->seq, ticket + 1, __ATOMIC_RELEASE);
+}
+
 /**
  * @brief Queue an asynchronus memory copy. The transfer is not started unless
- * dm_start or dm_wait is issued
+ * dm_start or dm_wait is issued, or the DM queue fills up
  * @details block only if DM queue is full
  *
  * @param dest destination pointer
@@ -258,37 +349,33 @@ inline void dm_exit(void) {
  * @param n number of bytes to copy
  * @return transfer ID
  */
-inline void dm_memcpy_async(void *dest, const void *src, size_t n) {
-    uint32_t s;
+inline dm_txid_t dm_memcpy_async(void *dest, const void *src, size_t n) {
+    uint32_t ticket;
+    volatile dm_slot_t *slot;
     volatile dm_task_t *t;
 
     DM_PRINTF(10, "dm_memcpy_async %#x -> %#x size %d\n", src, dest,
               (uint32_t)n);
 
-    // poll queue size
-    do {
-        s = __atomic_load_n(&dm_p->queue_fill, __ATOMIC_RELAXED);
-    } while (s >= DM_TASK_QUEUE_SIZE);
-    _dm_mtx_lock();
+    // reserve
+    slot = dm_reserve_slot(&ticket);
 
     // insert
-    t = &dm_p->queue[dm_p->queue_front];
+    t = &slot->task;
     t->src = (uint64_t)src;
     t->dst = (uint64_t)dest;
     t->size = (uint32_t)n;
     t->twod = 0;
     t->cfg = 0;
 
-    // bump
-    __atomic_add_fetch(&dm_p->queue_fill, 1, __ATOMIC_RELAXED);
-    dm_p->queue_front = (dm_p->queue_front + 1) % DM_TASK_QUEUE_SIZE;
-
-    _dm_mtx_release();
+    // publish
+    dm_publish_slot(slot, ticket);
+    return ticket;
 }
 
 /**
  * @brief Queue an asynchronus memory copy. The transfer is not started unless
- * dm_start or dm_wait is issued
+ * dm_start or dm_wait is issued, or the DM queue fills up
  * @details block only if DM queue is full
  *
  * @param src source address
@@ -298,24 +385,23 @@ inline void dm_memcpy_async(void *dest, const void *src, size_t n) {
  * @param dstrd outer destination stride
  * @param nreps number of repetitions in outer dimension
  * @param cfg DMA configuration
+ * @return transfer ID
  */
-inline void dm_memcpy2d_async(uint64_t src, uint64_t dst, uint32_t size,
-                              uint32_t sstrd, uint32_t dstrd, uint32_t nreps,
-                              uint32_t cfg) {
-    uint32_t s;
+inline dm_txid_t dm_memcpy2d_async(uint64_t src, uint64_t dst, uint32_t size,
+                                   uint32_t sstrd, uint32_t dstrd,
+                                   uint32_t nreps, uint32_t cfg) {
+    uint32_t ticket;
+    volatile dm_slot_t *slot;
     volatile dm_task_t *t;
 
     DM_PRINTF(10, "dm_memcpy2d_async %#x -> %#x size %d\n", src, dst,
               (uint32_t)size);
 
-    // poll queue size
-    do {
-        s = __atomic_load_n(&dm_p->queue_fill, __ATOMIC_RELAXED);
-    } while (s >= DM_TASK_QUEUE_SIZE);
-    _dm_mtx_lock();
+    // reserve
+    slot = dm_reserve_slot(&ticket);
 
     // insert
-    t = &dm_p->queue[dm_p->queue_front];
+    t = &slot->task;
     t->src = src;
     t->dst = dst;
     t->size = size;
@@ -325,11 +411,9 @@ inline void dm_memcpy2d_async(uint64_t src, uint64_t dst, uint32_t size,
     t->twod = 1;
     t->cfg = cfg;
 
-    // bump
-    __atomic_add_fetch(&dm_p->queue_fill, 1, __ATOMIC_RELAXED);
-    dm_p->queue_front = (dm_p->queue_front + 1) % DM_TASK_QUEUE_SIZE;
-
-    _dm_mtx_release();
+    // publish
+    dm_publish_slot(slot, ticket);
+    return ticket;
 }
 
 /**
@@ -343,15 +427,15 @@ inline void dm_start(void) { wake_dm(); }
  * @details
  */
 inline void dm_wait(void) {
-    uint32_t s;
+    uint32_t front = __atomic_load_n(&dm_p->queue_front, __ATOMIC_RELAXED);
 
     // signal data mover
     wake_dm();
 
-    // first, wait for the dm queue to be empty and no request be pending
-    do {
-        s = __atomic_load_n(&dm_p->queue_fill, __ATOMIC_RELAXED);
-    } while (s != 0);
+    // first, wait for all tasks queued so far to be issued and no request be
+    // pending
+    while ((int32_t)(dm_p->queue_back - front) < 0)
+        ;
     while (dm_p->stat_q)
         ;
 
@@ -369,6 +453,24 @@ inline void dm_wait(void) {
     _dm_mtx_release();
 }
 
+/**
+ * @brief Wait for a single queued transfer to complete
+ * @details Unlike dm_wait, does not wait for the DMA to be idle, so other cores
+ * can keep queueing transfers in the meantime. Also starts the queued
+ * transfers if the DM core is asleep.
+ *
+ * @param txid transfer ID returned by dm_memcpy_async or dm_memcpy2d_async
+ */
+inline void dm_wait_txid(dm_txid_t txid) {
+    // wait for the task to be issued
+    while ((int32_t)(dm_p->queue_back - txid) <= 0) poke_dm();
+
+    // the DM core stays awake until the transfer completes
+    uint32_t hw_txid = txid + dm_p->txid_offset;
+    while ((int32_t)(dm_p->completed_txid - hw_txid) < 0)
+        ;
+}
+
 /**
  * @brief Wait for the DM core to be ready
  * @details
@@ -2,6 +2,8 @@
 // Licensed under the Apache License, Version 2.0, see LICENSE for details.
 // SPDX-License-Identifier: Apache-2.0
 
+__thread snrt_dma_callback_queue_t _snrt_dma_callbacks;
+
 extern snrt_dma_txid_t snrt_dma_start_1d_wideptr(uint64_t dst, uint64_t src,
                                                  size_t size);
 
@@ -20,3 +22,15 @@ extern snrt_dma_txid_t snrt_dma_start_2d(void *dst, const void *src,
 extern void snrt_dma_wait(snrt_dma_txid_t tid);
 
 extern void snrt_dma_wait_all();
+
+extern snrt_dma_txid_t snrt_dma_completed_id();
+
+extern int snrt_dma_on_complete(snrt_dma_txid_t tid, snrt_dma_callback_t fn,
+                                void *arg);
+
+extern uint32_t snrt_dma_poll();
+
+extern void snrt_dma_wait_yield(snrt_dma_txid_t tid, snrt_dma_callback_t idle,
+                                void *arg);
+
+extern void snrt_dma_start_zero_global(uint64_t dst, size_t size);
@@ -27,6 +27,25 @@
 /// A DMA transfer identifier.
 typedef uint32_t snrt_dma_txid_t;
 
+/// A function to invoke on completion of a DMA transfer.
+typedef void (*snrt_dma_callback_t)(void *arg);
+
+#define SNRT_DMA_MAX_CALLBACKS 8
+
+typedef struct {
+    snrt_dma_txid_t tid;
+    snrt_dma_callback_t fn;
+    void *arg;
+} snrt_dma_callback_entry_t;
+
+/// Pending completion callbacks, in order of registration.
+typedef struct {
+    uint32_t num;
+    snrt_dma_callback_entry_t entries[SNRT_DMA_MAX_CALLBACKS];
+} snrt_dma_callback_queue_t;
+
+extern __thread snrt_dma_callback_queue_t _snrt_dma_callbacks;
+
 /**
  * @brief Start an asynchronous 1D DMA transfer with 64-bit wide pointers.
  * @param dst The destination address.
@@ -363,6 +382,85 @@ inline void snrt_dma_wait_all_channels(uint32_t num_channels) {
     }
 }
 
+/**
+ * @brief Get the ID of the last completed DMA transfer.
+ * @details A transfer with ID `tid` has completed if the returned ID is
+ *          greater than or equal to `tid`.
+ */
+inline snrt_dma_txid_t snrt_dma_completed_id() {
+    // dmstati t0, 0  # 0=status.completed_id
+    register uint32_t reg_id asm("t0");  // 5
+    asm volatile(".word %1\n"
+                 : "=r"(reg_id)
+                 : "i"(R_TYPE_ENCODE(DMSTATI_FUNCT7, 0b00, 0, XDMA_FUNCT3, 5,
+                                     OP_CUSTOM1)));
+    return reg_id;
+}
+
+/**
+ * @brief Register a function to invoke once a DMA transfer completes.
+ * @details Callbacks are not invoked asynchronously, but by the calling core
+ *          from @ref snrt_dma_poll or @ref snrt_dma_wait_yield, in order of
+ *          registration. Every core has its own registry.
+ * @param tid The ID of the transfer.
+ * @param fn The function to invoke.
+ * @param arg The argument to pass to @p fn.
+ * @return 0 on success, -1 if all @ref SNRT_DMA_MAX_CALLBACKS entries are
+ *         in use.
+ */
+inline int snrt_dma_on_complete(snrt_dma_txid_t tid, snrt_dma_callback_t fn,
+                                void *arg) {
+    snrt_dma_callback_queue_t *queue = &_snrt_dma_callbacks;
+    if (queue->num == SNRT_DMA_MAX_CALLBACKS) return -1;
+    queue->entries[queue->num++] = (snrt_dma_callback_entry_t){tid, fn, arg};
+    return 0;
+}
+
+/**
+ * @brief Invoke the callbacks of all completed DMA transfers.
+ * @return The number of callbacks which are still pending.
+ */
+inline uint32_t snrt_dma_poll() {
+    snrt_dma_callback_queue_t *queue = &_snrt_dma_callbacks;
+    if (!queue->num) return 0;
+
+    // Transfers complete in order, so the ready callbacks form a prefix
+    snrt_dma_txid_t completed = snrt_dma_completed_id();
+    uint32_t num_ready = 0;
+    while (num_ready < queue->num && queue->entries[num_ready].tid <= completed)
+        num_ready++;
+    if (!num_ready) return queue->num;
+
+    // Dequeue the ready callbacks before invoking them, so that they can
+    // register new callbacks themselves
+    snrt_dma_callback_entry_t ready[SNRT_DMA_MAX_CALLBACKS];
+    for (uint32_t i = 0; i < num_ready; i++) ready[i] = queue->entries[i];
+    for (uint32_t i = num_ready; i < queue->num; i++)
+        queue->entries[i - num_ready] = queue->entries[i];
+    queue->num -= num_ready;
+    for (uint32_t i = 0; i < num_ready; i++) ready[i].fn(ready[i].arg);
+    return queue->num;
+}
+
+/**
+ * @brief Wait for a DMA transfer to finish, doing other work meanwhile.
+ * @details Unlike @ref snrt_dma_wait, the core does not stall on the DMA
+ *          status. Until the transfer completes, it repeatedly invokes the
+ *          callbacks of completed transfers and the @p idle function.
+ * @param tid The ID of the transfer.
+ * @param idle A function to invoke while waiting, e.g. to service a work
+ *             queue. Should return quickly. Can be NULL.
+ * @param arg The argument to pass to @p idle.
+ */
+inline void snrt_dma_wait_yield(snrt_dma_txid_t tid, snrt_dma_callback_t idle,
+                                void *arg) {
+    while (snrt_dma_completed_id() < tid) {
+        snrt_dma_poll();
+        if (idle) idle(arg);
+    }
+    snrt_dma_poll();
+}
+
 /**
  * @brief Start tracking of dma performance region. Does not have any
  * implications on the HW. Only injects a marker in the DMA traces that can be
@@ -407,6 +505,41 @@ inline void snrt_dma_memset(void *ptr, uint8_t value, uint32_t len) {
     snrt_dma_wait_all();
 }
 
+/**
+ * @brief Start clearing a memory region together with the DM cores of all
+ *        clusters.
+ * @details The region is split evenly across the DMA channels of all
+ *          clusters. Every slice is cleared from the zero memory of the
+ *          calling cluster, in chunks no larger than the zero memory.
+ * @note Must be invoked by the DM core of every cluster. Completion must be
+ *       awaited on all of the cluster's DMA channels.
+ * @param dst The address of the region.
+ * @param size The size of the region in bytes.
+ */
+inline void snrt_dma_start_zero_global(uint64_t dst, size_t size) {
+    uint32_t num_channels = SNRT_CLUSTER_DMA_NUM_CHANNELS;
+    uint64_t src = (size_t)snrt_zero_memory_ptr();
+    size_t zero_size = snrt_zero_memory_size();
+    size_t num_slices = snrt_cluster_num() * num_channels;
+    // Align slices to the wide (512-bit) DMA bus
+    size_t slice_size = ALIGN_UP((size + num_slices - 1) / num_slices, 64);
+
+    for (uint32_t c = 0; c < num_channels; c++) {
+        size_t slice = snrt_cluster_idx() * num_channels + c;
+        size_t offset = slice * slice_size;
+        size_t end = offset + slice_size;
+        if (end > size) end = size;
+        for (; offset < end; offset += zero_size) {
+            size_t len = end - offset;
+            if (len > zero_size) len = zero_size;
+            if (c == 0)
+                snrt_dma_start_1d_wideptr(dst + offset, src, len);
+            else
+                snrt_dma_start_1d_channel_wideptr(dst + offset, src, len, c);
+        }
+    }
+}
+
 /**
  * @brief Load a tile of a 1D array.
  * @param dst Pointer to the tile destination.
@@ -0,0 +1,17 @@
+// Copyright 2023 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+extern void snrt_memcpy_cpu(void *dst, const void *src, size_t n);
+
+extern void snrt_memset_cpu(void *ptr, int value, size_t n);
+
+extern int snrt_memops_dma_available();
+
+extern void snrt_memcpy_dma(void *dst, const void *src, size_t n);
+
+extern void snrt_memset_dma(void *ptr, int value, size_t n);
+
+extern void *snrt_memcpy(void *dst, const void *src, size_t n);
+
+extern void *snrt_memset(void *ptr, int value, size_t num);
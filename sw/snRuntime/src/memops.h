@@ -0,0 +1,185 @@
+// Copyright 2023 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ * @file
+ * @brief This file provides memory copy and initialization functions which
+ *        can be invoked from any core.
+ * @details Small operations are performed by the calling core with unrolled
+ *          64-bit accesses. Large operations are performed by the DMA, either
+ *          directly, if invoked from the DM core, or by delegating them to the
+ *          data mover (see `dm.h`) otherwise.
+ */
+
+#pragma once
+
+/**
+ * @brief Size in bytes from which operations are offloaded to the DMA.
+ * @details Can be overridden at compile time. The `memops` test reports the
+ *          crossover point between the two implementations.
+ */
+#ifndef SNRT_MEMOPS_DMA_THRESHOLD
+#define SNRT_MEMOPS_DMA_THRESHOLD 512
+#endif
+
+/**
+ * @brief Copy a memory region with the calling core.
+ * @details If source and destination share the same alignment modulo 8
+ *          bytes, the bulk of the region is copied with unrolled 64-bit FP
+ *          loads and stores.
+ */
+inline void snrt_memcpy_cpu(void *dst, const void *src, size_t n) {
+    uint8_t *d = (uint8_t *)dst;
+    const uint8_t *s = (const uint8_t *)src;
+
+    if ((((uintptr_t)d ^ (uintptr_t)s) & 7) == 0) {
+        while (n && ((uintptr_t)d & 7)) {
+            *d++ = *s++;
+            n--;
+        }
+        double *d64 = (double *)d;
+        const double *s64 = (const double *)s;
+        for (; n >= 32; n -= 32, d64 += 4, s64 += 4) {
+            double a = s64[0], b = s64[1], c = s64[2], e = s64[3];
+            d64[0] = a;
+            d64[1] = b;
+            d64[2] = c;
+            d64[3] = e;
+        }
+        for (; n >= 8; n -= 8) *d64++ = *s64++;
+        d = (uint8_t *)d64;
+        s = (const uint8_t *)s64;
+        snrt_fpu_fence();
+    }
+    while (n--) *d++ = *s++;
+}
+
+/**
+ * @brief Initialize a memory region with the calling core.
+ * @details The bulk of the region is written with unrolled 64-bit FP stores.
+ */
+inline void snrt_memset_cpu(void *ptr, int value, size_t n) {
+    uint8_t *p = (uint8_t *)ptr;
+
+    while (n && ((uintptr_t)p & 7)) {
+        *p++ = (uint8_t)value;
+        n--;
+    }
+    if (n >= 8) {
+        union {
+            uint64_t u;
+            double d;
+        } pattern = {.u = 0x0101010101010101ull * (uint8_t)value};
+        double *p64 = (double *)p;
+        for (; n >= 32; n -= 32, p64 += 4) {
+            p64[0] = pattern.d;
+            p64[1] = pattern.d;
+            p64[2] = pattern.d;
+            p64[3] = pattern.d;
+        }
+        for (; n >= 8; n -= 8) *p64++ = pattern.d;
+        p = (uint8_t *)p64;
+        snrt_fpu_fence();
+    }
+    while (n--) *p++ = (uint8_t)value;
+}
+
+/**
+ * @brief Check whether the calling core can offload operations to the DMA.
+ * @details This is the case for the DM core, and for any core which
+ *          initialized the data mover (see @ref dm_init) as long as the DM
+ *          core has not been sent to exit.
+ */
+inline int snrt_memops_dma_available() {
+    if (snrt_is_dm_core()) return 1;
+    return dm_p && dm_p->stat_q != STAT_EXIT;
+}
+
+/**
+ * @brief Copy a memory region with the DMA, blocking.
+ * @note See @ref snrt_memops_dma_available for the cores which can use this
+ *       function.
+ */
+inline void snrt_memcpy_dma(void *dst, const void *src, size_t n) {
+    if (snrt_is_dm_core()) {
+        snrt_dma_wait(snrt_dma_start_1d(dst, src, n));
+    } else {
+        dm_wait_txid(dm_memcpy_async(dst, src, n));
+    }
+}
+
+/**
+ * @brief Initialize a memory region with the DMA, blocking.
+ * @details Zeros are streamed from the zero memory. Other values are written
+ *          to the first 64 bytes of the region, which the DMA then replicates
+ *          over the rest of it.
+ * @note See @ref snrt_memops_dma_available for the cores which can use this
+ *       function.
+ */
+inline void snrt_memset_dma(void *ptr, int value, size_t n) {
+    uint8_t *p = (uint8_t *)ptr;
+    int is_dm_core = snrt_is_dm_core();
+    uint32_t txid;
+
+    if (n == 0) return;
+    if ((uint8_t)value == 0) {
+        const void *zero = (const void *)snrt_zero_memory_ptr();
+        size_t zero_size = snrt_zero_memory_size();
+        for (size_t offset = 0; offset < n; offset += zero_size) {
+            size_t len = n - offset;
+            if (len > zero_size) len = zero_size;
+            if (is_dm_core)
+                txid = snrt_dma_start_1d(p + offset, zero, len);
+            else
+                txid = dm_memcpy_async(p + offset, zero, len);
+        }
+    } else {
+        if (n < 128) {
+            snrt_memset_cpu(ptr, value, n);
+            return;
+        }
+        size_t reps = n / 64 - 1;
+        size_t tail = n % 64;
+        snrt_memset_cpu(p, value, 64);
+        snrt_memset_cpu(p + n - tail, value, tail);
+        if (is_dm_core)
+            txid = snrt_dma_start_2d(p + 64, p, 64, 64, 0, reps);
+        else
+            txid = dm_memcpy2d_async((uintptr_t)p, (uintptr_t)(p + 64), 64,
+                                     0, 64, reps, 0);
+    }
+
+    if (is_dm_core)
+        snrt_dma_wait(txid);
+    else
+        dm_wait_txid(txid);
+}
+
+/**
+ * @brief Copy a memory region.
+ * @details Dispatches to @ref snrt_memcpy_dma from
+ *          @ref SNRT_MEMOPS_DMA_THRESHOLD bytes onwards, if the calling core
+ *          can offload to the DMA, and to @ref snrt_memcpy_cpu otherwise.
+ * @return The destination pointer.
+ */
+inline void *snrt_memcpy(void *dst, const void *src, size_t n) {
+    if (n >= SNRT_MEMOPS_DMA_THRESHOLD && snrt_memops_dma_available())
+        snrt_memcpy_dma(dst, src, n);
+    else
+        snrt_memcpy_cpu(dst, src, n);
+    return dst;
+}
+
+/**
+ * @brief Initialize a memory region.
+ * @details Dispatches like @ref snrt_memcpy.
+ * @return The pointer to the region.
+ */
+inline void *snrt_memset(void *ptr, int value, size_t num) {
+    if (num >= SNRT_MEMOPS_DMA_THRESHOLD && snrt_memops_dma_available())
+        snrt_memset_dma(ptr, value, num);
+    else
+        snrt_memset_cpu(ptr, value, num);
+    return ptr;
+}
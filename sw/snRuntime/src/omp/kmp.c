@@ -24,6 +24,9 @@ typedef void (*__task_type64)(_kmp_ptr64, _kmp_ptr64, _kmp_ptr64);
  */
 _kmp_ptr32 *kmpc_args;
 
+static void __kmp_tasks_drain(void);
+static void __kmp_tasks_barrier(snrt_barrier_t *barr, uint32_t n);
+
 static void __microtask_wrapper(void *arg, uint32_t argc) {
     kmp_int32 id = omp_get_thread_num();
     kmp_int32 *id_addr = (kmp_int32 *)(&id);
@@ -89,6 +92,8 @@ static void __microtask_wrapper(void *arg, uint32_t argc) {
                p_argv[10], p_argv[11]);
             break;
     }
+    // all tasks created in the parallel region complete at its end
+    __kmp_tasks_drain();
     // for performance tracking in traces
     cycle = read_csr(mcycle);
 }
@@ -125,7 +130,7 @@ void __kmpc_barrier(ident_t *loc, kmp_int32 tid) {
     _OMP_T *_this = omp_getData();
     uint32_t ret;
     KMP_PRINTF(50, "barrier numThreads: %d\n", (uint32_t)_this->numThreads);
-    snrt_partial_barrier(_this->kmpc_barrier, (uint32_t)_this->numThreads);
+    __kmp_tasks_barrier(_this->kmpc_barrier, (uint32_t)_this->numThreads);
 }
 
 /*!
@@ -380,12 +385,642 @@ void __kmpc_for_static_fini(ident_t *loc, kmp_int32 globaltid) {
 //                *plastiter, *plower, *pupper, incr, *pstride, chunk);
 // }
 
+//================================================================================
+// Reductions
+//
+// The private copies of the threads are combined pairwise in a binary tree in
+// TCDM: thread i with lowest set bit 2^k first folds in the subtrees of
+// threads i + 1, i + 2, ..., i + 2^(k-1), then signals its own subtree as
+// complete. Combining is done by the compiler-generated reduce_func, so
+// floating-point partials stay in FP registers and no lock is taken. Thread 0
+// ends up with the result of the team and is the only one asked to store it
+// to the shared variables.
+//================================================================================
+
+/**
+ * @brief Number of reductions this thread has taken part in, tags the
+ * signals in omp_reduce_t so they never need to be reset
+ */
+static __thread int kmp_reduce_epoch;
+
+static kmp_int32 __kmp_tree_reduce(void *reduce_data,
+                                   void (*reduce_func)(void *lhs_data,
+                                                       void *rhs_data)) {
+    _OMP_T *omp = omp_getData();
+    omp_reduce_t *red = omp->kmpc_reduce;
+    unsigned threadNum = omp_get_thread_num();
+    unsigned nbThreads = omp_get_team(omp)->nbThreads;
+    int epoch = ++kmp_reduce_epoch;
+
+    red->data[threadNum] = reduce_data;
+    for (unsigned stride = 1; stride < nbThreads; stride *= 2) {
+        if (threadNum & stride) break;
+        unsigned partner = threadNum + stride;
+        if (partner < nbThreads) {
+            while (red->arrived[partner] - epoch < 0)
+                ;
+            reduce_func(reduce_data, red->data[partner]);
+        }
+    }
+    red->arrived[threadNum] = epoch;
+
+    KMP_PRINTF(50, "__kmp_tree_reduce T#%d epoch %d\n", threadNum, epoch);
+    return threadNum == 0;
+}
+
+/*!
+@ingroup SYNCHRONIZATION
+@param loc source location information.
+@param global_tid global thread number.
+@param num_vars number of items (variables) to be reduced
+@param reduce_size size of data in bytes to be reduced
+@param reduce_data pointer to data to be reduced
+@param reduce_func callback function providing reduction operation on two
+operands and returning result of reduction in lhs_data
+@param lck pointer to the unique lock data structure
+@result 1 for the master thread, 0 for all other team threads, 2 for all team
+threads if atomic reduction needed
+
+The nowait version is used for a reduce clause with the nowait argument.
+Workers return as soon as their private copy has been combined.
+*/
+kmp_int32 __kmpc_reduce_nowait(ident_t *loc, kmp_int32 global_tid,
+                               kmp_int32 num_vars, size_t reduce_size,
+                               void *reduce_data,
+                               void (*reduce_func)(void *lhs_data,
+                                                   void *rhs_data),
+                               kmp_critical_name *lck) {
+    (void)loc;
+    (void)global_tid;
+    (void)num_vars;
+    (void)reduce_size;
+    (void)lck;
+    omp_reduce_t *red = omp_getData()->kmpc_reduce;
+
+    if (__kmp_tree_reduce(reduce_data, reduce_func)) return 1;
+
+    // The private copy must stay alive until the whole tree is combined
+    while (red->arrived[0] - kmp_reduce_epoch < 0)
+        ;
+    return 0;
+}
+
+/*!
+@ingroup SYNCHRONIZATION
+@param loc source location information
+@param global_tid global thread id.
+@param lck pointer to the unique lock data structure
+
+Finish the execution of a reduce nowait.
+*/
+void __kmpc_end_reduce_nowait(ident_t *loc, kmp_int32 global_tid,
+                              kmp_critical_name *lck) {
+    (void)loc;
+    (void)global_tid;
+    (void)lck;
+    KMP_PRINTF(50, "__kmpc_end_reduce_nowait\n");
+}
+
+/*!
+@ingroup SYNCHRONIZATION
+@param loc source location information.
+@param global_tid global thread number.
+@param num_vars number of items (variables) to be reduced
+@param reduce_size size of data in bytes to be reduced
+@param reduce_data pointer to data to be reduced
+@param reduce_func callback function providing reduction operation on two
+operands and returning result of reduction in lhs_data
+@param lck pointer to the unique lock data structure
+@result 1 for the master thread, 0 for all other team threads, 2 for all team
+threads if atomic reduction needed
+
+A blocking reduce that includes an implicit barrier: workers return only once
+the master has stored the result in __kmpc_end_reduce.
+*/
+kmp_int32 __kmpc_reduce(ident_t *loc, kmp_int32 global_tid, kmp_int32 num_vars,
+                        size_t reduce_size, void *reduce_data,
+                        void (*reduce_func)(void *lhs_data, void *rhs_data),
+                        kmp_critical_name *lck) {
+    (void)loc;
+    (void)global_tid;
+    (void)num_vars;
+    (void)reduce_size;
+    (void)lck;
+    omp_reduce_t *red = omp_getData()->kmpc_reduce;
+
+    if (__kmp_tree_reduce(reduce_data, reduce_func)) return 1;
+
+    while (red->release - kmp_reduce_epoch < 0)
+        ;
+    return 0;
+}
+
+/*!
+@ingroup SYNCHRONIZATION
+@param loc source location information
+@param global_tid global thread id.
+@param lck pointer to the unique lock data structure
+
+Finish the execution of a blocking reduce, releasing the workers.
+*/
+void __kmpc_end_reduce(ident_t *loc, kmp_int32 global_tid,
+                       kmp_critical_name *lck) {
+    (void)loc;
+    (void)global_tid;
+    (void)lck;
+    KMP_PRINTF(50, "__kmpc_end_reduce\n");
+    omp_getData()->kmpc_reduce->release = kmp_reduce_epoch;
+}
+
+//================================================================================
+// Tasking
+//
+// Explicit tasks are allocated from a bounded pool of fixed-size descriptors in
+// TCDM, claimed and released with AMOs on a bitmask, and queued on a deque per
+// thread. The owner pushes and pops at the tail, idle threads steal from the
+// head; every deque has its own lock so there is no global one. Threads look
+// for tasks to run whenever they have to wait: in taskwait, in barriers and at
+// the end of the parallel region. Tasks which do not fit the pool, in number
+// or size, are staged on a per-thread stack in L3 and run immediately, from a
+// copy on the thread's call stack, which pops them off the stack right away.
+// Only undeferred tasks, which the compiler runs in place, keep their stack
+// space while they run, so only their nesting can exhaust the stack.
+// The pool, the deques and the stacks are only allocated once the first task
+// is created, so programs without tasks do not pay for them.
+//================================================================================
+
+#define KMP_TASKDATA_STACK 0x1
+#define KMP_TASKDATA_INLINE 0x2
+#define KMP_TASKDATA_SIZE_SHIFT 2
+
+#define KMP_TASK_TO_TASKDATA(task) ((kmp_taskdata_t *)(task)-1)
+#define KMP_TASKDATA_TO_TASK(td) ((kmp_task_t *)((td) + 1))
+
+/**
+ * @brief Task the thread is executing, NULL for its implicit task
+ */
+static __thread kmp_taskdata_t *kmp_current_task;
+
+/**
+ * @brief Bytes in use of the thread's stack of immediately executed tasks
+ */
+static __thread uint32_t kmp_task_sp;
+
+/**
+ * @brief Number of single constructs this thread has encountered
+ */
+static __thread int kmp_single_epoch;
+
+static inline kmp_taskdata_t *__kmp_current_taskdata(omp_tasking_t *tasking) {
+    if (kmp_current_task) return kmp_current_task;
+    return &tasking->implicit[omp_get_thread_num()];
+}
+
+/**
+ * @brief Get the task pool, allocating it on first use
+ */
+static omp_task_pool_t *__kmp_task_pool(omp_tasking_t *tasking) {
+    omp_task_pool_t *pool = tasking->pool;
+    if (pool) return pool;
+
+    snrt_mutex_acquire(&tasking->lock);
+    pool = tasking->pool;
+    if (!pool) {
+        unsigned nbThreads = omp_get_team(omp_getData())->nbThreads;
+        pool = (omp_task_pool_t *)snrt_l1_alloc(sizeof(omp_task_pool_t));
+        snrt_memset(pool, 0, sizeof(omp_task_pool_t));
+        pool->stack =
+            (uint64_t *)snrt_l3_alloc(nbThreads * OMP_TASK_STACK_SIZE);
+        __atomic_store_n(&tasking->pool, pool, __ATOMIC_RELEASE);
+    }
+    snrt_mutex_release(&tasking->lock);
+    return pool;
+}
+
+static kmp_taskdata_t *__kmp_taskdata_alloc(omp_tasking_t *tasking,
+                                            size_t size) {
+    omp_task_pool_t *pool = __kmp_task_pool(tasking);
+    kmp_taskdata_t *td;
+
+    // Try to claim a free descriptor from the pool
+    if (size <= OMP_TASK_DESC_SIZE) {
+        uint32_t used;
+        while ((used = tasking->used) != (1ull << OMP_TASK_POOL_SIZE) - 1) {
+            uint32_t idx = __builtin_ctz(~used);
+            uint32_t mask = 1 << idx;
+            if (!(__atomic_fetch_or(&tasking->used, mask, __ATOMIC_RELAXED) &
+                  mask)) {
+                td = (kmp_taskdata_t *)pool->desc[idx];
+                td->flags = 0;
+                return td;
+            }
+        }
+    }
+
+    // Fall back to the stack of the thread. It only runs out if undeferred
+    // tasks nest beyond OMP_TASK_STACK_SIZE bytes.
+    size = ALIGN_UP(size, sizeof(uint64_t));
+    if (kmp_task_sp + size > OMP_TASK_STACK_SIZE) {
+        printf("error: out of task stack, %d of %d bytes in use\n",
+               (int)kmp_task_sp, OMP_TASK_STACK_SIZE);
+        snrt_exit(-1);
+    }
+    td = (kmp_taskdata_t *)((uint8_t *)pool->stack +
+                            omp_get_thread_num() * OMP_TASK_STACK_SIZE +
+                            kmp_task_sp);
+    kmp_task_sp += size;
+    td->flags = KMP_TASKDATA_STACK | (size << KMP_TASKDATA_SIZE_SHIFT);
+    return td;
+}
+
+/**
+ * @brief Drop a reference to a task, freeing its descriptor with the last one
+ */
+static inline void __kmp_taskdata_release(omp_tasking_t *tasking,
+                                          kmp_taskdata_t *td) {
+    if (__atomic_fetch_add(&td->refs, -1, __ATOMIC_RELAXED) != 1) return;
+    if (td->flags & KMP_TASKDATA_STACK) {
+        kmp_task_sp -= td->flags >> KMP_TASKDATA_SIZE_SHIFT;
+    } else if (!(td->flags & KMP_TASKDATA_INLINE)) {
+        uint32_t idx = ((uint64_t *)td - tasking->pool->desc[0]) /
+                       (OMP_TASK_DESC_SIZE / sizeof(uint64_t));
+        __atomic_fetch_and(&tasking->used, ~(1 << idx), __ATOMIC_RELAXED);
+    }
+}
+
+static inline int __kmp_deque_push(omp_task_deque_t *dq, kmp_taskdata_t *td) {
+    int ret = 0;
+    snrt_mutex_acquire(&dq->lock);
+    if (dq->tail - dq->head < OMP_TASK_DEQUE_SIZE) {
+        dq->slot[dq->tail % OMP_TASK_DEQUE_SIZE] = td;
+        dq->tail++;
+        ret = 1;
+    }
+    snrt_mutex_release(&dq->lock);
+    return ret;
+}
+
+static inline kmp_taskdata_t *__kmp_deque_take(omp_task_deque_t *dq,
+                                               int steal) {
+    kmp_taskdata_t *td = NULL;
+    if (dq->head == dq->tail) return NULL;
+    snrt_mutex_acquire(&dq->lock);
+    if (dq->head != dq->tail) {
+        if (steal)
+            td = dq->slot[dq->head++ % OMP_TASK_DEQUE_SIZE];
+        else
+            td = dq->slot[--dq->tail % OMP_TASK_DEQUE_SIZE];
+    }
+    snrt_mutex_release(&dq->lock);
+    return td;
+}
+
+static void __kmp_task_execute(omp_tasking_t *tasking, kmp_taskdata_t *td) {
+    kmp_task_t *task = KMP_TASKDATA_TO_TASK(td);
+    kmp_taskdata_t *parent = td->parent;
+
+    td->prev = kmp_current_task;
+    kmp_current_task = td;
+    task->routine(omp_get_thread_num(), task);
+    kmp_current_task = td->prev;
+
+    __kmp_taskdata_release(tasking, td);
+    __kmp_taskdata_release(tasking, parent);
+    __atomic_add_fetch(&tasking->pending, -1, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Run one queued task, preferably our own most recent one
+ * @return 1 if a task was run, 0 if no task was found
+ */
+static int __kmp_task_schedule(omp_tasking_t *tasking) {
+    omp_task_pool_t *pool = tasking->pool;
+    if (!pool) return 0;
+
+    unsigned threadNum = omp_get_thread_num();
+    unsigned nbThreads = omp_get_team(omp_getData())->nbThreads;
+    kmp_taskdata_t *td = __kmp_deque_take(&pool->deque[threadNum], 0);
+
+    for (unsigned i = 1; !td && i < nbThreads; i++)
+        td = __kmp_deque_take(&pool->deque[(threadNum + i) % nbThreads], 1);
+    if (!td) return 0;
+
+    __kmp_task_execute(tasking, td);
+    return 1;
+}
+
+/**
+ * @brief Help running tasks until all tasks of the team have completed
+ */
+static void __kmp_tasks_drain(void) {
+    omp_tasking_t *tasking = omp_getData()->kmpc_tasking;
+    while (tasking->pending) __kmp_task_schedule(tasking);
+}
+
+/**
+ * @brief Barrier which is a task scheduling point, see snrt_partial_barrier
+ * @details Threads keep running tasks until all threads have arrived. The last
+ * one to arrive only releases the others once all tasks have completed.
+ */
+static void __kmp_tasks_barrier(snrt_barrier_t *barr, uint32_t n) {
+    omp_tasking_t *tasking = omp_getData()->kmpc_tasking;
+    uint32_t prev_it = barr->iteration;
+    uint32_t cnt = __atomic_add_fetch(&barr->cnt, 1, __ATOMIC_RELAXED);
+
+    if (cnt == n) {
+        barr->cnt = 0;
+        __kmp_tasks_drain();
+        __atomic_add_fetch(&barr->iteration, 1, __ATOMIC_RELAXED);
+    } else {
+        while (prev_it == barr->iteration) __kmp_task_schedule(tasking);
+    }
+}
+
+/*!
+@ingroup TASKING
+@param loc_ref location of the original task directive
+@param gtid global thread number
+@param flags tiedness, final and other flags of the task
+@param sizeof_kmp_task_t size in bytes of kmp_task_t plus the privates
+@param sizeof_shareds size in bytes of the pointers to shared variables
+@param task_entry routine executing the task
+@return the allocated task, to be filled in and passed to __kmpc_omp_task
+*/
+kmp_task_t *__kmpc_omp_task_alloc(ident_t *loc_ref, kmp_int32 gtid,
+                                  kmp_int32 flags, size_t sizeof_kmp_task_t,
+                                  size_t sizeof_shareds,
+                                  kmp_routine_entry_t task_entry) {
+    (void)loc_ref;
+    (void)gtid;
+    (void)flags;
+    omp_tasking_t *tasking = omp_getData()->kmpc_tasking;
+    size_t offset_shareds =
+        ALIGN_UP(sizeof(kmp_taskdata_t) + sizeof_kmp_task_t, sizeof(void *));
+    kmp_taskdata_t *td =
+        __kmp_taskdata_alloc(tasking, offset_shareds + sizeof_shareds);
+    kmp_task_t *task = KMP_TASKDATA_TO_TASK(td);
+
+    td->refs = 1;
+    td->parent = __kmp_current_taskdata(tasking);
+    task->shareds = sizeof_shareds ? (uint8_t *)td + offset_shareds : NULL;
+    task->routine = task_entry;
+    task->part_id = 0;
+
+    KMP_PRINTF(50, "__kmpc_omp_task_alloc td %#x size %d\n", (uint32_t)td,
+               offset_shareds + sizeof_shareds);
+    return task;
+}
+
+/*!
+@ingroup TASKING
+@param loc_ref location of the original task directive
+@param gtid global thread number
+@param new_task task allocated by __kmpc_omp_task_alloc
+@return always 0
+
+Queue the task for execution by any thread of the team. Tasks which did not
+get a pool descriptor or do not fit the queue are run immediately.
+*/
+kmp_int32 __kmpc_omp_task(ident_t *loc_ref, kmp_int32 gtid,
+                          kmp_task_t *new_task) {
+    (void)loc_ref;
+    (void)gtid;
+    omp_tasking_t *tasking = omp_getData()->kmpc_tasking;
+    kmp_taskdata_t *td = KMP_TASK_TO_TASKDATA(new_task);
+
+    __atomic_add_fetch(&td->parent->refs, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&tasking->pending, 1, __ATOMIC_RELAXED);
+
+    if (td->flags & KMP_TASKDATA_STACK) {
+        // Copy the task to the call stack, popping it off the task stack,
+        // which is on top since it was allocated
+        uint32_t size = td->flags >> KMP_TASKDATA_SIZE_SHIFT;
+        kmp_taskdata_t *copy = (kmp_taskdata_t *)__builtin_alloca(size);
+        for (uint32_t i = 0; i < size / sizeof(uint64_t); i++)
+            ((uint64_t *)copy)[i] = ((uint64_t *)td)[i];
+        kmp_task_t *task = KMP_TASKDATA_TO_TASK(copy);
+        if (task->shareds)
+            task->shareds =
+                (uint8_t *)copy + ((uint8_t *)task->shareds - (uint8_t *)td);
+        copy->flags = KMP_TASKDATA_INLINE;
+        kmp_task_sp -= size;
+        td = copy;
+    }
+
+    if (td->flags & KMP_TASKDATA_INLINE) {
+        // Its children must complete before its frame is left
+        td->refs++;
+        __kmp_task_execute(tasking, td);
+        while (td->refs > 1) __kmp_task_schedule(tasking);
+        __kmp_taskdata_release(tasking, td);
+    } else if (!__kmp_deque_push(&tasking->pool->deque[omp_get_thread_num()],
+                                 td)) {
+        __kmp_task_execute(tasking, td);
+    }
+    return 0;
+}
+
+/*!
+@ingroup TASKING
+@param loc_ref location of the original task directive
+@param gtid global thread number
+@return always 0
+
+Wait for the completion of all child tasks of the current task, running
+queued tasks in the meantime.
+*/
+kmp_int32 __kmpc_omp_taskwait(ident_t *loc_ref, kmp_int32 gtid) {
+    (void)loc_ref;
+    (void)gtid;
+    omp_tasking_t *tasking = omp_getData()->kmpc_tasking;
+    kmp_taskdata_t *current = __kmp_current_taskdata(tasking);
+
+    KMP_PRINTF(50, "__kmpc_omp_taskwait refs %d\n", current->refs);
+    while (current->refs > 1) __kmp_task_schedule(tasking);
+    return 0;
+}
+
+/*!
+@ingroup TASKING
+@param loc_ref location of the original task directive
+@param gtid global thread number
+@param task task allocated by __kmpc_omp_task_alloc
+
+Start an undeferred task, e.g. with a false if clause, which the compiler runs
+inline.
+*/
+void __kmpc_omp_task_begin_if0(ident_t *loc_ref, kmp_int32 gtid,
+                               kmp_task_t *task) {
+    (void)loc_ref;
+    (void)gtid;
+    kmp_taskdata_t *td = KMP_TASK_TO_TASKDATA(task);
+
+    td->prev = kmp_current_task;
+    kmp_current_task = td;
+}
+
+/*!
+@ingroup TASKING
+@param loc_ref location of the original task directive
+@param gtid global thread number
+@param task task started by __kmpc_omp_task_begin_if0
+
+Finish an undeferred task.
+*/
+void __kmpc_omp_task_complete_if0(ident_t *loc_ref, kmp_int32 gtid,
+                                  kmp_task_t *task) {
+    (void)loc_ref;
+    (void)gtid;
+    omp_tasking_t *tasking = omp_getData()->kmpc_tasking;
+    kmp_taskdata_t *td = KMP_TASK_TO_TASKDATA(task);
+
+    kmp_current_task = td->prev;
+    // Its children must complete before the stack space is popped
+    if (td->flags & KMP_TASKDATA_STACK)
+        while (td->refs > 1) __kmp_task_schedule(tasking);
+    __kmp_taskdata_release(tasking, td);
+}
+
+/*!
+@ingroup WORK_SHARING
+@param loc  source location information
+@param global_tid  global thread number
+@return One if this thread should execute the single construct, zero
+otherwise.
+
+Test whether to execute a <tt>single</tt> construct. The first thread to
+encounter the construct executes it.
+*/
+kmp_int32 __kmpc_single(ident_t *loc, kmp_int32 global_tid) {
+    (void)loc;
+    (void)global_tid;
+    omp_tasking_t *tasking = omp_getData()->kmpc_tasking;
+    int epoch = ++kmp_single_epoch;
+    int expected = epoch - 1;
+
+    // Only the first thread advances the epoch. With nowait, a fast thread
+    // may already have claimed a later construct, which a CAS leaves intact.
+    return __atomic_compare_exchange_n(&tasking->single, &expected, epoch, 0,
+                                       __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+}
+
+/*!
+@ingroup WORK_SHARING
+@param loc  source location information
+@param global_tid  global thread number
+
+Mark the end of a <tt>single</tt> construct.  This function should
+only be called by the thread that executed the block of code protected
+by the `single` construct.
+*/
+void __kmpc_end_single(ident_t *loc, kmp_int32 global_tid) {
+    (void)loc;
+    (void)global_tid;
+}
+
 //================================================================================
 // Dynamic scheduling
 // Only available if not OMPSTATIC_NUMTHREADS
+//
+// Every thread owns a deque of chunk indices in TCDM, initialized with a
+// static block partition of the loop. A thread claims chunks from the head of
+// its own deque and, once that is empty, steals from the tail of the deques of
+// the other threads. Head and tail share a word, the head in the lower and the
+// tail in the upper half, so a claim on either end is a single amoadd that
+// also returns a consistent snapshot of both: it succeeded iff head < tail in
+// the returned value. A failed claim leaves head > tail behind, which still
+// reads as empty.
 //================================================================================
 #ifndef OMPSTATIC_NUMTHREADS
 
+/**
+ * @brief Maximum number of chunks of a dynamically scheduled loop. Keeps the
+ * head from overflowing into the tail, larger loops use larger chunks
+ */
+#define KMP_DEQUE_MAX_CHUNKS 0x7fff
+
+#define KMP_DEQUE_HEAD(b) ((kmp_int32)((b)&0xffff))
+#define KMP_DEQUE_TAIL(b) ((kmp_int32)(b) >> 16)
+#define KMP_DEQUE_BOUNDS(h, t) (((kmp_uint32)(t) << 16) | (kmp_uint32)(h))
+
+/**
+ * @brief Thread-private state of the dynamically scheduled loop in flight
+ */
+typedef struct {
+    kmp_int32 lb;
+    kmp_int32 st;
+    kmp_uint32 trip;
+    kmp_uint32 chunk;
+    // claim half of the remaining chunks at a time instead of a single one
+    kmp_uint32 guided;
+    // steal from other threads when the own deque is empty
+    kmp_uint32 steal;
+    // next thread to steal from
+    kmp_uint32 victim;
+    int epoch;
+} kmp_dispatch_t;
+
+static __thread kmp_dispatch_t kmp_dispatch;
+
+static inline int __kmp_deque_pop(volatile omp_deque_t *dq, kmp_uint32 guided,
+                                  kmp_int32 *first, kmp_int32 *last) {
+    kmp_uint32 b = dq->bounds;
+    kmp_int32 avail = KMP_DEQUE_TAIL(b) - KMP_DEQUE_HEAD(b);
+    if (avail <= 0) return 0;
+
+    kmp_int32 n = guided ? (avail + 1) / 2 : 1;
+    b = __atomic_fetch_add(&dq->bounds, (kmp_uint32)n, __ATOMIC_RELAXED);
+    kmp_int32 h = KMP_DEQUE_HEAD(b), t = KMP_DEQUE_TAIL(b);
+    if (h >= t) return 0;
+
+    *first = h;
+    *last = h + n < t ? h + n : t;
+    return 1;
+}
+
+static inline int __kmp_deque_steal(volatile omp_deque_t *dq,
+                                    kmp_uint32 guided, kmp_int32 *first,
+                                    kmp_int32 *last) {
+    kmp_uint32 b = dq->bounds;
+    kmp_int32 avail = KMP_DEQUE_TAIL(b) - KMP_DEQUE_HEAD(b);
+    if (avail <= 0) return 0;
+
+    kmp_int32 n = guided ? (avail + 1) / 2 : 1;
+    b = __atomic_fetch_add(&dq->bounds, -((kmp_uint32)n << 16),
+                           __ATOMIC_RELAXED);
+    kmp_int32 h = KMP_DEQUE_HEAD(b), t = KMP_DEQUE_TAIL(b);
+    if (h >= t) return 0;
+
+    *first = t - n > h ? t - n : h;
+    *last = t;
+    return 1;
+}
+
+static int __kmp_steal(omp_team_t *team, kmp_dispatch_t *d, unsigned threadNum,
+                       kmp_int32 *first, kmp_int32 *last) {
+    unsigned nbThreads = team->nbThreads;
+    unsigned pending;
+
+    // Retry as long as some deque had work left but we lost the race for it
+    do {
+        pending = 0;
+        for (unsigned i = 0; i < nbThreads; i++) {
+            unsigned v = (d->victim + i) % nbThreads;
+            volatile omp_deque_t *dq = &team->deque[v];
+            // Skip ourselves and deques not yet set up for this loop
+            if (v == threadNum || dq->epoch != d->epoch) continue;
+            kmp_uint32 b = dq->bounds;
+            if (KMP_DEQUE_HEAD(b) >= KMP_DEQUE_TAIL(b)) continue;
+            pending = 1;
+            if (__kmp_deque_steal(dq, d->guided, first, last)) {
+                d->victim = v;
+                return 1;
+            }
+        }
+    } while (pending);
+    return 0;
+}
+
 /*!
 @ingroup WORK_SHARING
 @{
@@ -401,49 +1036,71 @@ This function prepares the runtime to start a dynamically scheduled for loop,
 saving the loop arguments.
 These functions are all identical apart from the types of the arguments.
 */
-// void __kmpc_dispatch_init_4(ident_t *loc, kmp_int32 gtid,
-//                             enum sched_type schedule, kmp_int32 lb,
-//                             kmp_int32 ub, kmp_int32 st, kmp_int32 chunk) {
-//     (void)loc;
-//     (void)gtid;
-//     (void)schedule;
-//     omp_team_t *team = omp_get_team(omp_getData());
-//     // dynLoopInitNoIter(team, lb, ub, st, chunk);
-//     // int core_id = omp_get_thread_num();
-//     eu_mutex_lock();
-//     // if (team->loop_epoch - team->core_epoch[core_id] != 0)
-//     // {
-//     //   eu_mutex_release();
-//     //   team->core_epoch[core_id]++;
-//     //   KMP_PRINTF(10, "__kmpc_dispatch_init_4 core_epoch[%d] =
-//     //   %d\n",core_id,team->core_epoch[core_id]); return;
-//     // }
-
-//     if (!team->loop_is_setup) {
-//         team->loop_is_setup = 1;
-//         team->loop_start = lb;
-//         team->loop_end = ub;
-//         team->loop_incr = st;
-//         team->loop_chunk = chunk;
-//         KMP_PRINTF(
-//             10,
-//             "__kmpc_dispatch_init_4 setup: start %d end %d incr %d chunk
-//             %d\n", team->loop_start, team->loop_end, team->loop_incr,
-//             team->loop_chunk);
-//     }
-//     eu_mutex_release();
-// }
+void __kmpc_dispatch_init_4(ident_t *loc, kmp_int32 gtid,
+                            enum sched_type schedule, kmp_int32 lb,
+                            kmp_int32 ub, kmp_int32 st, kmp_int32 chunk) {
+    (void)loc;
+    (void)gtid;
+    omp_team_t *team = omp_get_team(omp_getData());
+    kmp_dispatch_t *d = &kmp_dispatch;
+    unsigned threadNum = omp_get_thread_num();
+    unsigned nbThreads = team->nbThreads;
+    kmp_int32 trip = (ub - lb) / st + 1;
+
+    schedule = SCHEDULE_WITHOUT_MODIFIERS(schedule);
+    KMP_PRINTF(10,
+               "__kmpc_dispatch_init_4 sched %d lb %d ub %d st %d chunk %d\n",
+               schedule, lb, ub, st, chunk);
+
+    d->lb = lb;
+    d->st = st;
+    d->trip = trip > 0 ? trip : 0;
+    d->guided = schedule == kmp_sch_guided_chunked ||
+                schedule == kmp_sch_guided_iterative_chunked ||
+                schedule == kmp_sch_guided_analytical_chunked ||
+                schedule == kmp_sch_guided_simd;
+    d->steal = schedule != kmp_sch_static &&
+               schedule != kmp_sch_static_chunked &&
+               schedule != kmp_sch_static_balanced &&
+               schedule != kmp_sch_static_greedy;
+    d->victim = (threadNum + 1) % nbThreads;
+    d->epoch = team->core_epoch[threadNum] + 1;
+
+    // Static schedules are not stolen from, so each thread gets one chunk
+    if (!d->steal) chunk = (d->trip + nbThreads - 1) / nbThreads;
+    if (chunk < 1) chunk = 1;
+    if (d->trip / chunk >= KMP_DEQUE_MAX_CHUNKS)
+        chunk = (d->trip + KMP_DEQUE_MAX_CHUNKS - 1) / KMP_DEQUE_MAX_CHUNKS;
+    d->chunk = chunk;
+
+    // Partition the chunks in contiguous blocks
+    kmp_int32 nchunks = (d->trip + chunk - 1) / chunk;
+    kmp_int32 per_thread = nchunks / nbThreads;
+    kmp_int32 leftOver = nchunks - per_thread * nbThreads;
+    kmp_int32 first = threadNum * per_thread +
+                      ((int)threadNum < leftOver ? threadNum : leftOver);
+    kmp_int32 last = first + per_thread + ((int)threadNum < leftOver);
+
+    // Make sure no thread is still stealing from the previous loop, this can
+    // only happen for nowait loops
+    for (unsigned i = 0; i < nbThreads; i++)
+        while (team->core_epoch[i] < d->epoch - 1)
+            ;
+
+    team->deque[threadNum].bounds = KMP_DEQUE_BOUNDS(first, last);
+    team->deque[threadNum].epoch = d->epoch;
+}
 
 /*!
 See @ref __kmpc_dispatch_init_4
 */
-// void __kmpc_dispatch_init_4u(ident_t *loc, kmp_int32 gtid,
-//                              enum sched_type schedule, kmp_uint32 lb,
-//                              kmp_uint32 ub, kmp_int32 st, kmp_int32 chunk) {
-//     kmp_int32 ilb = (kmp_int32)lb;
-//     kmp_int32 iub = (kmp_int32)ub;
-//     __kmpc_dispatch_init_4(loc, gtid, schedule, ilb, iub, st, chunk);
-// }
+void __kmpc_dispatch_init_4u(ident_t *loc, kmp_int32 gtid,
+                             enum sched_type schedule, kmp_uint32 lb,
+                             kmp_uint32 ub, kmp_int32 st, kmp_int32 chunk) {
+    kmp_int32 ilb = (kmp_int32)lb;
+    kmp_int32 iub = (kmp_int32)ub;
+    __kmpc_dispatch_init_4(loc, gtid, schedule, ilb, iub, st, chunk);
+}
 
 /*!
 @param loc Source code location
@@ -458,56 +1115,49 @@ otherwise
 Get the next dynamically allocated chunk of work for this thread.
 If there is no more work, then the lb,ub and stride need not be modified.
 */
-// int __kmpc_dispatch_next_4(ident_t *loc, kmp_int32 gtid, kmp_int32 *p_last,
-//                            kmp_int32 *p_lb, kmp_int32 *p_ub, kmp_int32 *p_st)
-//                            {
-//     (void)loc;
-//     (void)gtid;
-
-//     omp_team_t *team = omp_get_team(omp_getData());
+int __kmpc_dispatch_next_4(ident_t *loc, kmp_int32 gtid, kmp_int32 *p_last,
+                           kmp_int32 *p_lb, kmp_int32 *p_ub, kmp_int32 *p_st) {
+    (void)loc;
+    (void)gtid;
+    omp_team_t *team = omp_get_team(omp_getData());
+    kmp_dispatch_t *d = &kmp_dispatch;
+    unsigned threadNum = omp_get_thread_num();
+    kmp_int32 first, last;
 
-//     // The stride is actually always 1
-//     *p_st = 1;
+    if (!__kmp_deque_pop(&team->deque[threadNum], d->guided, &first, &last) &&
+        !(d->steal && __kmp_steal(team, d, threadNum, &first, &last))) {
+        // Done with this loop, our deque may be reused from now on
+        team->core_epoch[threadNum] = d->epoch;
+        KMP_PRINTF(10, "__kmpc_dispatch_next_4 done\n");
+        return 0;
+    }
 
-//     // int result = dynLoopIter(team, (int*) p_lb, (int*) p_ub, (int*)
-//     p_last); eu_mutex_lock();
+    kmp_uint32 iter_first = first * d->chunk;
+    kmp_uint32 iter_last = last * d->chunk;
+    if (iter_last > d->trip) iter_last = d->trip;
 
-//     // have already iterated over all the iterations(no more work), return 0
-//     if (team->loop_start > team->loop_end) {
-//         team->loop_is_setup = 0;
-//         KMP_PRINTF(
-//             10, "__kmpc_dispatch_next_4 start > end: team->loop_is_setup
-//             %d\n", team->loop_is_setup);
-//         eu_mutex_release();
-//         return 0;
-//     }
+    *p_lb = d->lb + iter_first * d->st;
+    *p_ub = d->lb + (iter_last - 1) * d->st;
+    *p_st = d->st;
+    if (p_last != NULL) *p_last = iter_last == d->trip;
 
-//     *p_lb = team->loop_start;
-//     *p_ub = *p_lb + team->loop_chunk - 1;
-//     if (*p_ub >= team->loop_end) {
-//         *p_ub = team->loop_end;
-//         *p_last = 1;
-//     }
-
-//     team->loop_start += team->loop_chunk;
-//     KMP_PRINTF(10,
-//                "__kmpc_dispatch_next_4 : last: %d [l %4d u %4d s %4d] "
-//                "team->loop_start %d\n",
-//                *p_last, *p_lb, *p_ub, *p_st, team->loop_start);
-//     eu_mutex_release();
-//     return 1;
-// }
+    KMP_PRINTF(10, "__kmpc_dispatch_next_4 : last: %d [l %4d u %4d s %4d]\n",
+               iter_last == d->trip, *p_lb, *p_ub, *p_st);
+    return 1;
+}
 
 /*!
 See @ref __kmpc_dispatch_next_4
 */
-// int __kmpc_dispatch_next_4u(ident_t *loc, kmp_int32 gtid, kmp_int32 *p_last,
-//                             kmp_uint32 *p_lb, kmp_uint32 *p_ub,
-//                             kmp_int32 *p_st) {
-//     kmp_int32 p_lbi = *p_lb;
-//     kmp_int32 p_ubi = *p_ub;
-//     int ret = __kmpc_dispatch_next_4(loc, gtid, p_last, &p_lbi, &p_ubi,
-//     p_st); *p_lb = p_lbi; *p_ub = p_ubi; return ret;
-// }
+int __kmpc_dispatch_next_4u(ident_t *loc, kmp_int32 gtid, kmp_int32 *p_last,
+                            kmp_uint32 *p_lb, kmp_uint32 *p_ub,
+                            kmp_int32 *p_st) {
+    kmp_int32 p_lbi = *p_lb;
+    kmp_int32 p_ubi = *p_ub;
+    int ret = __kmpc_dispatch_next_4(loc, gtid, p_last, &p_lbi, &p_ubi, p_st);
+    *p_lb = p_lbi;
+    *p_ub = p_ubi;
+    return ret;
+}
 
 #endif  // #ifndef OMPSTATIC_NUMTHREADS
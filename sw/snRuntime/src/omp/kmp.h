@@ -173,6 +173,43 @@ enum sched_type : kmp_int32 {
 
 typedef void (*kmpc_micro)(kmp_int32 *global_tid, kmp_int32 *bound_tid, ...);
 
+typedef kmp_int32 kmp_critical_name[8];
+
+typedef kmp_int32 (*kmp_routine_entry_t)(kmp_int32, void *);
+
+typedef union kmp_cmplrdata {
+    kmp_int32 priority; /**< priority specified by user for the task */
+    kmp_routine_entry_t
+        destructors; /* pointer to function to invoke deconstructors of
+                        firstprivate C++ objects */
+} kmp_cmplrdata_t;
+
+/*!
+ * The task descriptor shared with the compiler. The private variables of the
+ * task follow it in memory.
+ */
+typedef struct kmp_task {
+    void *shareds; /**< pointer to block of pointers to shared vars   */
+    kmp_routine_entry_t
+        routine;       /**< pointer to routine to call for executing task */
+    kmp_int32 part_id; /**< part id for the task                          */
+    kmp_cmplrdata_t
+        data1; /* Two known optional additions: destructors and priority */
+    kmp_cmplrdata_t data2; /* Process destructors first, priority second */
+} kmp_task_t;
+
+/*!
+ * Runtime bookkeeping of a task, placed right in front of its kmp_task_t.
+ */
+typedef struct kmp_taskdata {
+    // 1 until the task completes, plus the number of incomplete children
+    volatile kmp_int32 refs;
+    kmp_int32 flags;
+    struct kmp_taskdata *parent;
+    // task the executing thread was running before this one
+    struct kmp_taskdata *prev;
+} kmp_taskdata_t;
+
 ////////////////////////////////////////////////////////////////////////////////
 // data
 ////////////////////////////////////////////////////////////////////////////////
@@ -45,6 +45,15 @@ static inline void initTeam(omp_t *_this, omp_team_t *team) {
     (void)team;
 }
 
+static omp_tasking_t *omp_tasking_alloc(unsigned nbThreads) {
+    omp_tasking_t *tasking =
+        (omp_tasking_t *)snrt_l1_alloc(sizeof(omp_tasking_t));
+    snrt_memset(tasking, 0, sizeof(omp_tasking_t));
+    // implicit tasks never complete
+    for (unsigned i = 0; i < nbThreads; i++) tasking->implicit[i].refs = 1;
+    return tasking;
+}
+
 void omp_init(void) {
     if (snrt_cluster_core_idx() == 0) {
         // allocate space for kmp arguments
@@ -57,24 +66,32 @@ void omp_init(void) {
         omp_p->maxThreads = nbCores;
 
         omp_p->plainTeam.nbThreads = nbCores;
-        omp_p->plainTeam.loop_epoch = 0;
-        omp_p->plainTeam.loop_is_setup = 0;
 
         for (int i = 0; i < sizeof(omp_p->plainTeam.core_epoch) /
                                 sizeof(omp_p->plainTeam.core_epoch[0]);
-             i++)
+             i++) {
             omp_p->plainTeam.core_epoch[i] = 0;
+            omp_p->plainTeam.deque[i].bounds = 0;
+            omp_p->plainTeam.deque[i].epoch = 0;
+        }
 
         initTeam((omp_t *)omp_p, (omp_team_t *)&omp_p->plainTeam);
         omp_p->kmpc_barrier =
             (snrt_barrier_t *)snrt_l1_alloc(sizeof(snrt_barrier_t));
         snrt_memset(omp_p->kmpc_barrier, 0, sizeof(snrt_barrier_t));
+        omp_p->kmpc_reduce =
+            (omp_reduce_t *)snrt_l1_alloc(sizeof(omp_reduce_t));
+        snrt_memset(omp_p->kmpc_reduce, 0, sizeof(omp_reduce_t));
+        omp_p->kmpc_tasking = omp_tasking_alloc(nbCores);
         // Exchange omp pointer with other cluster cores
         omp_p_global = omp_p;
 #else
         omp_p.kmpc_barrier =
             (snrt_barrier_t *)snrt_l1_alloc(sizeof(snrt_barrier_t));
         snrt_memset(omp_p.kmpc_barrier, 0, sizeof(snrt_barrier_t));
+        omp_p.kmpc_reduce = (omp_reduce_t *)snrt_l1_alloc(sizeof(omp_reduce_t));
+        snrt_memset(omp_p.kmpc_reduce, 0, sizeof(omp_reduce_t));
+        omp_p.kmpc_tasking = omp_tasking_alloc(OMPSTATIC_NUMTHREADS);
         // Exchange omp pointer with other cluster cores
         omp_p_global = &omp_p;
 #endif
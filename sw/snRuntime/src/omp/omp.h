@@ -68,23 +68,102 @@
     dm_exit();                       \
     snrt_cluster_hw_barrier();
 
+/**
+ * @brief Number of task descriptors in the cluster-shared pool, at most 32
+ */
+#define OMP_TASK_POOL_SIZE 16
+/**
+ * @brief Size of a task descriptor, including the kmp bookkeeping, the
+ * private variables and the pointers to the shared variables of the task
+ */
+#define OMP_TASK_DESC_SIZE 128
+/**
+ * @brief Number of queued tasks per thread
+ */
+#define OMP_TASK_DEQUE_SIZE 8
+/**
+ * @brief Per-thread space in L3 for tasks which do not fit the pool and are
+ * run immediately. Deferred tasks only occupy it until they are copied to the
+ * call stack, undeferred tasks while they run, see kmp.c
+ */
+#define OMP_TASK_STACK_SIZE 4096
+
 //================================================================================
 // types
 //================================================================================
 
+/**
+ * @brief Per-thread work-stealing deque for dynamically scheduled loops. Holds
+ * the range of chunk indices [head, tail) still to be executed, packed into a
+ * single word so that either end can be claimed with one AMO, see kmp.c
+ */
+typedef struct {
+    volatile uint32_t bounds;
+    // number of the dynamically scheduled loop the bounds belong to
+    volatile int epoch;
+} omp_deque_t;
+
 typedef struct {
     char nbThreads;
 #ifndef OMPSTATIC_NUMTHREADS
-    int loop_epoch;
-    int loop_start;
-    int loop_end;
-    int loop_incr;
-    int loop_chunk;
-    int loop_is_setup;
-    int core_epoch[16];  // for dynamic scheduling
+    omp_deque_t deque[16];        // for dynamic scheduling
+    volatile int core_epoch[16];  // for dynamic scheduling
 #endif
 } omp_team_t;
 
+/**
+ * @brief Shared state of the tree-combining reductions, see kmp.c
+ */
+typedef struct {
+    // private reduction data of every thread
+    void *volatile data[16];
+    // last reduction for which a thread has combined its subtree
+    volatile int arrived[16];
+    // last reduction whose result has been stored by the master thread
+    volatile int release;
+} omp_reduce_t;
+
+/**
+ * @brief Queue of tasks ready to run, owned by a thread, see kmp.c
+ */
+typedef struct {
+    volatile uint32_t lock;
+    // steal end
+    volatile uint32_t head;
+    // owner end
+    volatile uint32_t tail;
+    kmp_taskdata_t *volatile slot[OMP_TASK_DEQUE_SIZE];
+} omp_task_deque_t;
+
+/**
+ * @brief Task descriptors and queues, only allocated once the first explicit
+ * task is created, see kmp.c
+ */
+typedef struct {
+    uint64_t desc[OMP_TASK_POOL_SIZE][OMP_TASK_DESC_SIZE / sizeof(uint64_t)];
+    omp_task_deque_t deque[16];
+    // OMP_TASK_STACK_SIZE bytes per thread, in L3
+    uint64_t *stack;
+} omp_task_pool_t;
+
+/**
+ * @brief Shared state of explicit tasks and single constructs, see kmp.c
+ */
+typedef struct {
+    // NULL until the first explicit task is created
+    omp_task_pool_t *volatile pool;
+    // guards the allocation of the pool
+    volatile uint32_t lock;
+    // bit i is set while descriptor i is allocated
+    volatile uint32_t used;
+    // tasks submitted but not completed yet
+    volatile int pending;
+    // last single construct claimed by a thread
+    volatile int single;
+    // implicit task of every thread
+    kmp_taskdata_t implicit[16];
+} omp_tasking_t;
+
 typedef struct {
 #ifndef OMPSTATIC_NUMTHREADS
     omp_team_t plainTeam;
@@ -101,6 +180,17 @@ typedef struct {
      *
      */
     snrt_barrier_t *kmpc_barrier;
+    /**
+     * @brief Pointer to the state used to combine the private copies of
+     * reduction variables eg with #pragma omp for reduction(+ : x)
+     *
+     */
+    omp_reduce_t *kmpc_reduce;
+    /**
+     * @brief Pointer to the task pool and queues used by #pragma omp task
+     *
+     */
+    omp_tasking_t *kmpc_tasking;
     /**
      * @brief Usually the arguments passed to __kmpc_fork_call would do a malloc
      * with the amount of arguments passed. This is too slow for our case and
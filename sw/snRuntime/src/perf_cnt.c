@@ -2,7 +2,7 @@
 // Licensed under the Apache License, Version 2.0, see LICENSE for details.
 // SPDX-License-Identifier: Apache-2.0
 
-extern void perf_regs_t* snrt_perf_counters();
+extern perf_regs_t* snrt_perf_counters();
 
 extern void snrt_cfg_perf_counter(uint32_t perf_cnt, uint16_t metric,
                                   uint16_t hart);
@@ -14,3 +14,65 @@ extern void snrt_stop_perf_counter(uint32_t perf_cnt);
 extern void snrt_reset_perf_counter(uint32_t perf_cnt);
 
 extern uint32_t snrt_get_perf_counter(uint32_t perf_cnt);
+
+extern void snrt_perf_region_config(const uint32_t* metrics,
+                                    uint32_t num_metrics);
+
+extern void snrt_perf_region_config_default();
+
+extern void snrt_perf_region_begin(uint32_t id);
+
+extern void snrt_perf_region_end(uint32_t id);
+
+extern uint32_t snrt_dma_stats_counter(uint32_t channel, uint32_t i);
+
+extern void snrt_dma_stats_start(uint32_t num_channels);
+
+extern void snrt_dma_stats_get(snrt_dma_stats_t* stats, uint32_t channel);
+
+void snrt_perf_region_dump() {
+    snrt_perf_profile_t* perf = &(cls()->perf);
+    uint32_t num_metrics = perf->num_metrics;
+    uint32_t num_regions = 0;
+
+    for (uint32_t id = 0; id < SNRT_PERF_MAX_REGIONS; id++)
+        if (perf->regions[id].count) num_regions++;
+    if (!num_regions) return;
+
+    // The record is emitted as a single line, which the host console
+    // reassembles and prints in one piece
+    printf("[perf] %08x%08x%08x", SNRT_PERF_RECORD_MAGIC,
+           (SNRT_PERF_RECORD_VERSION << 16) | snrt_cluster_idx(),
+           (num_metrics << 16) | num_regions);
+    for (uint32_t i = 0; i < num_metrics; i++)
+        printf("%08x", perf->metrics[i]);
+    for (uint32_t id = 0; id < SNRT_PERF_MAX_REGIONS; id++) {
+        snrt_perf_region_t* region = &(perf->regions[id]);
+        if (!region->count) continue;
+        printf("%08x%08x", id, region->count);
+        for (uint32_t i = 0; i < num_metrics; i++)
+            printf("%08x", region->total[i]);
+    }
+    printf("\n");
+}
+
+// Prints `num / den` with two decimal places.
+static void snrt_dma_stats_print_ratio(uint32_t num, uint32_t den) {
+    uint32_t ratio = den ? (uint64_t)num * 100 / den : 0;
+    printf("%u.%02u", ratio / 100, ratio % 100);
+}
+
+void snrt_dma_stats_dump() {
+    snrt_perf_profile_t* perf = &(cls()->perf);
+    for (uint32_t c = 0; c < perf->dma_num_channels; c++) {
+        snrt_dma_stats_t stats;
+        snrt_dma_stats_get(&stats, c);
+        printf("[dma] cluster=%u channel=%u bytes=%u bursts=%u busy=%u",
+               snrt_cluster_idx(), c, stats.bytes, stats.bursts, stats.busy);
+        printf(" cycles=%u bw_busy=", stats.cycles);
+        snrt_dma_stats_print_ratio(stats.bytes, stats.busy);
+        printf(" bw=");
+        snrt_dma_stats_print_ratio(stats.bytes, stats.cycles);
+        printf("\n");
+    }
+}
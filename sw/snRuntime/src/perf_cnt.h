@@ -83,3 +83,212 @@ inline void snrt_reset_perf_counter(uint32_t perf_cnt) {
 inline uint32_t snrt_get_perf_counter(uint32_t perf_cnt) {
     return snrt_perf_counters()->perf_counter[perf_cnt].value;
 }
+
+//================================================================================
+// Region profiler
+//================================================================================
+
+// The region profiler occupies the last `SNRT_PERF_MAX_METRICS` counters,
+// leaving the first ones free for manual use
+#define SNRT_PERF_REGION_FIRST_CNT (SNRT_NUM_PERF_CNTS - SNRT_PERF_MAX_METRICS)
+
+// Magic word and format version of the record emitted by
+// `snrt_perf_region_dump()`, keep in sync with `util/bench/roi.py`
+#define SNRT_PERF_RECORD_MAGIC 0x66726570
+#define SNRT_PERF_RECORD_VERSION 1
+
+/**
+ * @brief Expands to the selector value of a metric, given its name as listed
+ * in `snitch_cluster_peripheral.hjson`, e.g. `SNRT_PERF_METRIC_ID(CYCLE)`.
+ */
+#define SNRT_PERF_METRIC_ID(name) \
+    SNITCH_CLUSTER_PERIPHERAL_PERF_CNT_SEL_0_METRIC_0_VALUE_##name
+
+/**
+ * @brief Encodes a metric and hart pair as a performance counter selection.
+ */
+#define SNRT_PERF_METRIC(metric, hart) \
+    (((uint32_t)(metric) << 16) | ((hart)&0xffff))
+
+/**
+ * @brief Configures the metric set tracked by the region profiler.
+ *
+ * The counters are left free-running, so that regions can be nested and
+ * calling this function again with the same metric set does not disturb
+ * regions currently being profiled. Reconfiguring the metric set while a
+ * region is open invalidates that region's totals.
+ *
+ * @param metrics Array of counter selections, as encoded by
+ *                `SNRT_PERF_METRIC()`.
+ * @param num_metrics Number of metrics, at most `SNRT_PERF_MAX_METRICS`.
+ */
+inline void snrt_perf_region_config(const uint32_t* metrics,
+                                    uint32_t num_metrics) {
+    snrt_perf_profile_t* perf = &(cls()->perf);
+    if (num_metrics > SNRT_PERF_MAX_METRICS)
+        num_metrics = SNRT_PERF_MAX_METRICS;
+    for (uint32_t i = 0; i < num_metrics; i++) {
+        uint32_t cnt = SNRT_PERF_REGION_FIRST_CNT + i;
+        perf->metrics[i] = metrics[i];
+        snrt_perf_counters()->select[cnt].value = metrics[i];
+        snrt_start_perf_counter(cnt);
+    }
+    perf->num_metrics = num_metrics;
+}
+
+/**
+ * @brief Configures the region profiler with the default metric set.
+ *
+ * Tracks cycles, TCDM accesses and conflicts, DMA activity and instruction
+ * cache misses for the cluster, and FPU issues and retired instructions for
+ * the calling hart.
+ */
+inline void snrt_perf_region_config_default() {
+    uint32_t hart = snrt_cluster_core_idx();
+    const uint32_t metrics[] = {
+        SNRT_PERF_METRIC(SNRT_PERF_METRIC_ID(CYCLE), 0),
+        SNRT_PERF_METRIC(SNRT_PERF_METRIC_ID(TCDM_ACCESSED), 0),
+        SNRT_PERF_METRIC(SNRT_PERF_METRIC_ID(TCDM_CONGESTED), 0),
+        SNRT_PERF_METRIC(SNRT_PERF_METRIC_ID(ISSUE_FPU), hart),
+        SNRT_PERF_METRIC(SNRT_PERF_METRIC_ID(RETIRED_INSTR), hart),
+        SNRT_PERF_METRIC(SNRT_PERF_METRIC_ID(DMA_BUSY), 0),
+        SNRT_PERF_METRIC(SNRT_PERF_METRIC_ID(ICACHE_MISS), 0)};
+    snrt_perf_region_config(metrics, sizeof(metrics) / sizeof(metrics[0]));
+}
+
+/**
+ * @brief Opens a profiled region.
+ *
+ * Snapshots the configured counters, configuring the default metric set
+ * first if no metric set was configured. Regions are tracked per cluster:
+ * distinct regions may be open at the same time, also on different harts,
+ * but every instance of a region must be opened and closed by one hart.
+ *
+ * @param id The region identifier, less than `SNRT_PERF_MAX_REGIONS`.
+ *           Out-of-range identifiers are ignored.
+ */
+inline void snrt_perf_region_begin(uint32_t id) {
+    snrt_perf_profile_t* perf = &(cls()->perf);
+    if (id >= SNRT_PERF_MAX_REGIONS) return;
+    if (!perf->num_metrics) snrt_perf_region_config_default();
+    snrt_perf_region_t* region = &(perf->regions[id]);
+    for (uint32_t i = 0; i < perf->num_metrics; i++) {
+        uint32_t cnt = SNRT_PERF_REGION_FIRST_CNT + i;
+        region->start[i] = snrt_get_perf_counter(cnt);
+    }
+}
+
+/**
+ * @brief Closes a profiled region and accumulates its counter deltas.
+ *
+ * @param id The region identifier passed to `snrt_perf_region_begin()`.
+ */
+inline void snrt_perf_region_end(uint32_t id) {
+    snrt_perf_profile_t* perf = &(cls()->perf);
+    if (id >= SNRT_PERF_MAX_REGIONS) return;
+    snrt_perf_region_t* region = &(perf->regions[id]);
+    for (uint32_t i = 0; i < perf->num_metrics; i++) {
+        uint32_t cnt = SNRT_PERF_REGION_FIRST_CNT + i;
+        region->total[i] += snrt_get_perf_counter(cnt) - region->start[i];
+    }
+    region->count++;
+}
+
+/**
+ * @brief Prints the cluster's region totals as a hex-encoded binary record.
+ *
+ * The record is a single line starting with `[perf] `, followed by a
+ * sequence of 32-bit words, each printed as eight hex digits:
+ *   - `SNRT_PERF_RECORD_MAGIC`
+ *   - `(SNRT_PERF_RECORD_VERSION << 16) | cluster_idx`
+ *   - `(num_metrics << 16) | num_regions`
+ *   - `num_metrics` counter selections
+ *   - for each region that was entered at least once: its identifier, its
+ *     count and `num_metrics` totals.
+ * Nothing is printed if no region was entered. Called at exit by the DM core
+ * of every cluster, it can be parsed with `util/bench/roi.py --perf-log`.
+ */
+void snrt_perf_region_dump();
+
+//================================================================================
+// DMA statistics
+//================================================================================
+
+// Every DMA channel tracked by the DMA statistics occupies
+// `SNRT_DMA_STATS_CNTS_PER_CHANNEL` counters, allocated downwards from those
+// of the region profiler
+#define SNRT_DMA_STATS_CNTS_PER_CHANNEL 3
+#define SNRT_DMA_STATS_MAX_CHANNELS \
+    (SNRT_PERF_REGION_FIRST_CNT / SNRT_DMA_STATS_CNTS_PER_CHANNEL)
+
+/**
+ * @brief Returns the index of the `i`-th counter tracking a DMA channel.
+ */
+inline uint32_t snrt_dma_stats_counter(uint32_t channel, uint32_t i) {
+    return SNRT_PERF_REGION_FIRST_CNT -
+           (channel + 1) * SNRT_DMA_STATS_CNTS_PER_CHANNEL + i;
+}
+
+/**
+ * @brief Starts collecting statistics on the cluster's DMA channels.
+ *
+ * Unlike `snrt_dma_start_tracking()`, which only marks a region in the DMA
+ * trace, this counts written bytes, write bursts and busy cycles of every
+ * channel in hardware, so that bandwidth can be reported without traces.
+ * Calling it again restarts the statistics.
+ *
+ * @param num_channels Number of channels to track, starting from channel 0.
+ *                     Clamped to `SNRT_DMA_STATS_MAX_CHANNELS`.
+ */
+inline void snrt_dma_stats_start(uint32_t num_channels) {
+    snrt_perf_profile_t* perf = &(cls()->perf);
+    const uint32_t metrics[SNRT_DMA_STATS_CNTS_PER_CHANNEL] = {
+        SNRT_PERF_METRIC_ID(DMA_W_BW), SNRT_PERF_METRIC_ID(DMA_AW_DONE),
+        SNRT_PERF_METRIC_ID(DMA_BUSY)};
+    if (num_channels > SNRT_DMA_STATS_MAX_CHANNELS)
+        num_channels = SNRT_DMA_STATS_MAX_CHANNELS;
+    for (uint32_t c = 0; c < num_channels; c++) {
+        for (uint32_t i = 0; i < SNRT_DMA_STATS_CNTS_PER_CHANNEL; i++) {
+            uint32_t cnt = snrt_dma_stats_counter(c, i);
+            snrt_stop_perf_counter(cnt);
+            snrt_perf_counters()->select[cnt].value =
+                SNRT_PERF_METRIC(metrics[i], c);
+            snrt_reset_perf_counter(cnt);
+        }
+    }
+    perf->dma_num_channels = num_channels;
+    perf->dma_start_cycle = snrt_mcycle();
+    for (uint32_t c = 0; c < num_channels; c++)
+        for (uint32_t i = 0; i < SNRT_DMA_STATS_CNTS_PER_CHANNEL; i++)
+            snrt_start_perf_counter(snrt_dma_stats_counter(c, i));
+}
+
+/**
+ * @brief Retrieves the statistics collected so far on a DMA channel.
+ *
+ * Can be invoked by any core in the cluster. All statistics are zero for
+ * channels which are not being tracked.
+ *
+ * @param stats Pointer to the structure to fill.
+ * @param channel The index of the channel.
+ */
+inline void snrt_dma_stats_get(snrt_dma_stats_t* stats, uint32_t channel) {
+    snrt_perf_profile_t* perf = &(cls()->perf);
+    if (channel >= perf->dma_num_channels) {
+        *stats = (snrt_dma_stats_t){0};
+        return;
+    }
+    stats->cycles = snrt_mcycle() - perf->dma_start_cycle;
+    stats->bytes = snrt_get_perf_counter(snrt_dma_stats_counter(channel, 0));
+    stats->bursts = snrt_get_perf_counter(snrt_dma_stats_counter(channel, 1));
+    stats->busy = snrt_get_perf_counter(snrt_dma_stats_counter(channel, 2));
+}
+
+/**
+ * @brief Prints the statistics of every tracked DMA channel.
+ *
+ * Prints one line per channel, starting with `[dma] `, including the
+ * achieved bandwidth in bytes per cycle, both over the busy cycles and over
+ * all cycles since the statistics were started.
+ */
+void snrt_dma_stats_dump();
@@ -9,4 +9,8 @@
 
 extern void snrt_putchar(char character);
 
+// Push out characters still buffered by snrt_putchar, if the platform
+// buffers them at all
+extern void snrt_putchar_flush();
+
 #include "../../deps/printf/printf.h"
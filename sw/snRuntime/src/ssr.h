@@ -236,3 +236,285 @@ inline void snrt_ssr_write(enum snrt_ssr_dm dm, enum snrt_ssr_dim dim,
                            volatile void *ptr) {
     write_ssr_cfg(REG_WPTR + dim, dm, (uintptr_t)ptr);
 }
+
+//================================================================================
+// Stream descriptors
+//================================================================================
+
+/**
+ * @brief Precomputed configuration of an SSR stream.
+ *
+ * Holds the values of the repeat, bounds and strides registers exactly as
+ * they are written to the SSR, i.e. with bounds decremented and strides
+ * adjusted for the wrap-around of the inner loops. Building a descriptor
+ * once and applying it to every tile of a kernel thus replaces the
+ * arithmetic in `snrt_ssr_loop_*d()` with a plain sequence of register
+ * writes, and allows reprogramming only the fields which change, typically
+ * just the pointer.
+ */
+typedef struct {
+    enum snrt_ssr_dim dim; /**< Number of dimensions of the stream */
+    uint32_t repeat;       /**< Repetition count minus one */
+    uint32_t bounds[4];    /**< Loop bounds minus one */
+    uint32_t strides[4];   /**< Loop strides relative to the inner loops */
+} snrt_ssr_desc_t;
+
+/**
+ * @brief Initializer for a 1D stream descriptor.
+ *
+ * The `SNRT_SSR_DESC_*D()` initializers take the same arguments as the
+ * corresponding `snrt_ssr_loop_*d()` functions. If all arguments are
+ * constant they are constant expressions, so descriptors for fixed shapes
+ * can be declared `static const` and are fully resolved at compile time.
+ * The repetition count defaults to one, see `snrt_ssr_desc_repeat()`.
+ */
+#define SNRT_SSR_DESC_1D(b0, s0)                                   \
+    {                                                              \
+        .dim = SNRT_SSR_1D, .bounds = {(b0)-1}, .strides = {(s0)}, \
+    }
+
+/**
+ * @brief Initializer for a 2D stream descriptor.
+ */
+#define SNRT_SSR_DESC_2D(b0, b1, s0, s1)                \
+    {                                                   \
+        .dim = SNRT_SSR_2D, .bounds = {(b0)-1, (b1)-1}, \
+        .strides = {(s0), (s1) - (s0) * ((b0)-1)},      \
+    }
+
+/**
+ * @brief Initializer for a 3D stream descriptor.
+ */
+#define SNRT_SSR_DESC_3D(b0, b1, b2, s0, s1, s2)                \
+    {                                                           \
+        .dim = SNRT_SSR_3D, .bounds = {(b0)-1, (b1)-1, (b2)-1}, \
+        .strides = {(s0), (s1) - (s0) * ((b0)-1),               \
+                    (s2) - (s0) * ((b0)-1) - (s1) * ((b1)-1)},  \
+    }
+
+/**
+ * @brief Initializer for a 4D stream descriptor.
+ */
+#define SNRT_SSR_DESC_4D(b0, b1, b2, b3, s0, s1, s2, s3)                \
+    {                                                                   \
+        .dim = SNRT_SSR_4D, .bounds = {(b0)-1, (b1)-1, (b2)-1, (b3)-1}, \
+        .strides = {(s0), (s1) - (s0) * ((b0)-1),                       \
+                    (s2) - (s0) * ((b0)-1) - (s1) * ((b1)-1),           \
+                    (s3) - (s0) * ((b0)-1) - (s1) * ((b1)-1) -          \
+                        (s2) * ((b2)-1)},                               \
+    }
+
+/**
+ * @brief Set the repetition count of a stream descriptor.
+ * @param desc The stream descriptor.
+ * @param count The repetition count.
+ */
+inline void snrt_ssr_desc_repeat(snrt_ssr_desc_t *desc, size_t count) {
+    desc->repeat = count - 1;
+}
+
+/**
+ * @brief Program the repetition count and bounds of a stream descriptor.
+ *
+ * Only the registers of the descriptor's dimensions are written. On its
+ * own, this is only valid if the strides programmed in the SSR match the
+ * descriptor's, e.g. if only the outermost bound changes.
+ *
+ * @param dm The SSR index.
+ * @param desc The stream descriptor.
+ */
+inline void snrt_ssr_desc_apply_bounds(enum snrt_ssr_dm dm,
+                                       const snrt_ssr_desc_t *desc) {
+    write_ssr_cfg(REG_REPEAT, dm, desc->repeat);
+    switch (desc->dim) {
+        case SNRT_SSR_4D:
+            write_ssr_cfg(REG_BOUNDS + 3, dm, desc->bounds[3]);
+            // fall through
+        case SNRT_SSR_3D:
+            write_ssr_cfg(REG_BOUNDS + 2, dm, desc->bounds[2]);
+            // fall through
+        case SNRT_SSR_2D:
+            write_ssr_cfg(REG_BOUNDS + 1, dm, desc->bounds[1]);
+            // fall through
+        case SNRT_SSR_1D:
+            write_ssr_cfg(REG_BOUNDS + 0, dm, desc->bounds[0]);
+    }
+}
+
+/**
+ * @brief Program the strides of a stream descriptor.
+ * @param dm The SSR index.
+ * @param desc The stream descriptor.
+ */
+inline void snrt_ssr_desc_apply_strides(enum snrt_ssr_dm dm,
+                                        const snrt_ssr_desc_t *desc) {
+    switch (desc->dim) {
+        case SNRT_SSR_4D:
+            write_ssr_cfg(REG_STRIDES + 3, dm, desc->strides[3]);
+            // fall through
+        case SNRT_SSR_3D:
+            write_ssr_cfg(REG_STRIDES + 2, dm, desc->strides[2]);
+            // fall through
+        case SNRT_SSR_2D:
+            write_ssr_cfg(REG_STRIDES + 1, dm, desc->strides[1]);
+            // fall through
+        case SNRT_SSR_1D:
+            write_ssr_cfg(REG_STRIDES + 0, dm, desc->strides[0]);
+    }
+}
+
+/**
+ * @brief Program the full shape of a stream descriptor.
+ *
+ * Equivalent to the corresponding `snrt_ssr_loop_*d()` and
+ * `snrt_ssr_repeat()` calls. When the descriptors of multiple SSRs are
+ * identical, pass `SNRT_SSR_DM_ALL` to program them in a single burst.
+ *
+ * @param dm The SSR index.
+ * @param desc The stream descriptor.
+ */
+inline void snrt_ssr_desc_apply(enum snrt_ssr_dm dm,
+                                const snrt_ssr_desc_t *desc) {
+    snrt_ssr_desc_apply_bounds(dm, desc);
+    snrt_ssr_desc_apply_strides(dm, desc);
+}
+
+/**
+ * @brief Start a streaming read with the shape of a stream descriptor.
+ *
+ * Only writes the pointer, the shape must have been programmed before.
+ *
+ * @param dm The SSR index.
+ * @param desc The stream descriptor.
+ * @param ptr The pointer to the data.
+ */
+inline void snrt_ssr_desc_read(enum snrt_ssr_dm dm,
+                               const snrt_ssr_desc_t *desc,
+                               volatile void *ptr) {
+    switch (desc->dim) {
+        case SNRT_SSR_1D:
+            snrt_ssr_read(dm, SNRT_SSR_1D, ptr);
+            break;
+        case SNRT_SSR_2D:
+            snrt_ssr_read(dm, SNRT_SSR_2D, ptr);
+            break;
+        case SNRT_SSR_3D:
+            snrt_ssr_read(dm, SNRT_SSR_3D, ptr);
+            break;
+        case SNRT_SSR_4D:
+            snrt_ssr_read(dm, SNRT_SSR_4D, ptr);
+            break;
+    }
+}
+
+/**
+ * @brief Start a streaming write with the shape of a stream descriptor.
+ *
+ * Only writes the pointer, the shape must have been programmed before.
+ *
+ * @param dm The SSR index.
+ * @param desc The stream descriptor.
+ * @param ptr The pointer to the data.
+ */
+inline void snrt_ssr_desc_write(enum snrt_ssr_dm dm,
+                                const snrt_ssr_desc_t *desc,
+                                volatile void *ptr) {
+    switch (desc->dim) {
+        case SNRT_SSR_1D:
+            snrt_ssr_write(dm, SNRT_SSR_1D, ptr);
+            break;
+        case SNRT_SSR_2D:
+            snrt_ssr_write(dm, SNRT_SSR_2D, ptr);
+            break;
+        case SNRT_SSR_3D:
+            snrt_ssr_write(dm, SNRT_SSR_3D, ptr);
+            break;
+        case SNRT_SSR_4D:
+            snrt_ssr_write(dm, SNRT_SSR_4D, ptr);
+            break;
+    }
+}
+
+//================================================================================
+// Indirect streams
+//================================================================================
+
+/**
+ * @brief The SSR indirection registers.
+ *
+ * Indirection is only available on the SSRs configured with it, SSR 0 and 1
+ * in the default cluster configuration.
+ */
+enum {
+    REG_IDX_CFG = 10,    /**< Index size, shift and flags register */
+    REG_IDX_BASE = 11,   /**< Base address of the indirected data */
+    REG_IDX_ISECT = 12,  /**< Length of the last intersection */
+    REG_RPTR_INDIR = 16, /**< Indirect read pointer register */
+    REG_RPTR_ISECT = 18  /**< Intersection master read pointer register */
+};
+
+/**
+ * @brief The size of the elements of an index array.
+ */
+enum snrt_ssr_idx_size {
+    SNRT_SSR_IDX_U8 = 0,  /**< 8-bit indices */
+    SNRT_SSR_IDX_U16 = 1, /**< 16-bit indices */
+    SNRT_SSR_IDX_U32 = 2, /**< 32-bit indices */
+    SNRT_SSR_IDX_U64 = 3  /**< 64-bit indices */
+};
+
+/**
+ * @brief Configure the indices of an indirect stream.
+ *
+ * An indirect stream accesses the 64-bit elements `base[idx[i] << shift]`,
+ * for the `i` in the bound of the first loop, see `snrt_ssr_loop_1d()`.
+ * The stride is ignored, and the outer loops are not used.
+ *
+ * @param dm The SSR index.
+ * @param size The size of the indices.
+ * @param shift Additional left shift applied to the indices.
+ * @param merge Only used by intersection masters. If set, streams the
+ *              union of the index arrays instead of their intersection,
+ *              injecting zeros for the elements missing from either.
+ */
+inline void snrt_ssr_idx_cfg(enum snrt_ssr_dm dm, enum snrt_ssr_idx_size size,
+                             uint32_t shift, uint32_t merge) {
+    write_ssr_cfg(REG_IDX_CFG, dm, (merge << 16) | (shift << 8) | size);
+}
+
+/**
+ * @brief Set the base address of the data accessed by an indirect stream.
+ * @param dm The SSR index.
+ * @param base The pointer to the data.
+ */
+inline void snrt_ssr_idx_base(enum snrt_ssr_dm dm, volatile void *base) {
+    write_ssr_cfg(REG_IDX_BASE, dm, (uintptr_t)base);
+}
+
+/**
+ * @brief Start an indirect streaming read.
+ * @param dm The SSR index.
+ * @param idx The pointer to the index array.
+ */
+inline void snrt_ssr_read_indir(enum snrt_ssr_dm dm, volatile void *idx) {
+    write_ssr_cfg(REG_RPTR_INDIR, dm, (uintptr_t)idx);
+}
+
+/**
+ * @brief Start a streaming read of an index intersection.
+ *
+ * SSR 0 and 1 act as intersection masters: each streams the elements of
+ * its data at the positions of its sorted index array whose indices also
+ * appear in the other SSR's index array. As the length of the
+ * intersection is not known in advance, the stream terminates a
+ * stream-controlled FREP loop issued to consume it. Both SSRs must be
+ * started. Elements are accessed as `base[i]`, with `i` the position in
+ * the index array, so the index shift must be zero.
+ *
+ * @param dm The SSR index.
+ * @param idx The pointer to the sorted index array.
+ */
+inline void snrt_ssr_read_isect(enum snrt_ssr_dm dm, volatile void *idx) {
+    write_ssr_cfg(REG_RPTR_ISECT, dm, (uintptr_t)idx);
+}
+
@@ -48,16 +48,29 @@ static inline void snrt_init_tls() {
 #endif
 
 #ifdef SNRT_INIT_BSS
+// Number of DM cores which cleared their share of the .bss. It is placed
+// in .data, as the .bss is only valid once all DM cores are done.
+static volatile uint32_t _snrt_init_bss_done __attribute__((section(".data")));
+
 static inline void snrt_init_bss() {
     extern volatile uint32_t __bss_start, __bss_end;
 
-    // Only one core needs to perform the initialization
-    if (snrt_cluster_idx() == 0 && snrt_is_dm_core()) {
+    // The DM cores of all clusters clear a share of the .bss each
+    if (snrt_is_dm_core()) {
         size_t size = (size_t)(&__bss_end) - (size_t)(&__bss_start);
-        snrt_dma_start_1d_wideptr((uint64_t)(&__bss_start),
-                                  (uint64_t)(snrt_zero_memory_ptr()), size);
+        snrt_dma_start_zero_global((size_t)(&__bss_start), size);
     }
 }
+
+// Synchronizes the DM cores of all clusters once they cleared their share
+// of the .bss. Must be called after waiting for the transfers on channel 0.
+static inline void snrt_init_bss_join() {
+    for (uint32_t c = 1; c < SNRT_CLUSTER_DMA_NUM_CHANNELS; c++)
+        snrt_dma_wait_all_channel(c);
+    __atomic_add_fetch(&_snrt_init_bss_done, 1, __ATOMIC_RELAXED);
+    while (_snrt_init_bss_done != snrt_cluster_num())
+        ;
+}
 #endif
 
 #ifdef SNRT_INIT_CLS
@@ -128,7 +141,12 @@ void snrt_main() {
 #if defined(SNRT_INIT_BSS) || defined(SNRT_INIT_CLS)
     // Single DMA wait call and barrier for both snrt_init_bss() and
     // snrt_init_cls()
-    if (snrt_is_dm_core()) snrt_dma_wait_all();
+    if (snrt_is_dm_core()) {
+        snrt_dma_wait_all();
+#ifdef SNRT_INIT_BSS
+        snrt_init_bss_join();
+#endif
+    }
     snrt_cluster_hw_barrier();
 #endif
 
@@ -9,6 +9,9 @@
 volatile uint32_t _snrt_mutex;
 volatile snrt_barrier_t _snrt_barrier;
 volatile uint32_t _reduction_result;
+__thread uint32_t _snrt_reduction_chunks;
+__thread uint32_t _snrt_ring_chunks;
+__thread snrt_mcs_node_t _snrt_mcs_node;
 
 //================================================================================
 // Functions
@@ -22,13 +25,43 @@ extern void snrt_mutex_ttas_acquire(volatile uint32_t *pmtx);
 
 extern void snrt_mutex_release(volatile uint32_t *pmtx);
 
+extern void snrt_ticket_lock_acquire(snrt_ticket_lock_t *lock);
+
+extern void snrt_ticket_lock_release(snrt_ticket_lock_t *lock);
+
+extern void snrt_mcs_lock_acquire(snrt_mcs_lock_t *lock);
+
+extern void snrt_mcs_lock_release(snrt_mcs_lock_t *lock);
+
 extern void snrt_cluster_hw_barrier();
 
 extern void snrt_global_barrier();
 
 extern void snrt_partial_barrier(snrt_barrier_t *barr, uint32_t n);
 
+extern void snrt_elementwise_reduction(void *dst, void *src0, void *src1,
+                                       size_t len, precision_t prec,
+                                       snrt_reduction_op_t op);
+
+extern void snrt_group_reduction_dma_generic(void *dst_buffer,
+                                             void *src_buffer, size_t len,
+                                             precision_t prec,
+                                             snrt_reduction_op_t op,
+                                             uint32_t stride, uint32_t num);
+
+extern void snrt_global_reduction_dma_generic(void *dst_buffer,
+                                              void *src_buffer, size_t len,
+                                              precision_t prec,
+                                              snrt_reduction_op_t op);
+
 extern void snrt_global_reduction_dma(double *dst_buffer, double *src_buffer,
                                       size_t len);
 
 extern uint32_t snrt_global_all_to_all_reduction(uint32_t value);
+
+extern volatile uint32_t *snrt_remote_cls_ptr(volatile uint32_t *ptr,
+                                              uint32_t cluster_idx);
+
+extern void snrt_broadcast(void *dst_buffer, const void *src, size_t size);
+
+extern void snrt_allgather(void *dst_buffer, const void *src, size_t size);
@@ -69,6 +69,82 @@ inline void snrt_mutex_release(volatile uint32_t *pmtx) {
                  : "+r"(pmtx));
 }
 
+//================================================================================
+// Queue lock functions
+//================================================================================
+
+/**
+ * @brief Acquire a ticket lock, blocking.
+ * @details Every core draws a ticket with a single atomic increment and then
+ *          waits, with plain loads, until its ticket is being served. Unlike
+ *          @ref snrt_mutex_acquire, this issues a single AMO per acquisition
+ *          and grants the lock in FIFO order.
+ * @param lock A pointer to a zero-initialized lock, at a memory location to
+ *             which atomic accesses can be made.
+ */
+inline void snrt_ticket_lock_acquire(snrt_ticket_lock_t *lock) {
+    uint32_t ticket = __atomic_fetch_add(&lock->next, 1, __ATOMIC_RELAXED);
+    while (lock->serving != ticket)
+        ;
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+}
+
+/**
+ * @brief Release a previously-acquired ticket lock.
+ */
+inline void snrt_ticket_lock_release(snrt_ticket_lock_t *lock) {
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    lock->serving = lock->serving + 1;
+}
+
+/**
+ * @brief Acquire an MCS queue lock, blocking.
+ * @details Waiting cores form a queue, and every core spins on a flag in its
+ *          own queue node, which resides in its TLS (i.e. in the TCDM of its
+ *          cluster). The lock holder hands the lock over by writing the flag
+ *          of its successor, so waiting generates no traffic on the lock
+ *          variable itself, even for a lock shared by multiple clusters.
+ * @param lock A pointer to a zero-initialized lock, at a memory location to
+ *             which atomic accesses can be made.
+ * @note Since every core owns a single queue node, a core may hold at most
+ *       one MCS lock at a time.
+ */
+inline void snrt_mcs_lock_acquire(snrt_mcs_lock_t *lock) {
+    snrt_mcs_node_t *node = &_snrt_mcs_node;
+    node->next = NULL;
+    node->locked = 1;
+
+    // Enqueue, and wait for the predecessor (if any) to hand over the lock
+    snrt_mcs_node_t *pred =
+        __atomic_exchange_n(&lock->tail, node, __ATOMIC_ACQ_REL);
+    if (pred) {
+        pred->next = node;
+        while (node->locked)
+            ;
+    }
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+}
+
+/**
+ * @brief Release a previously-acquired MCS queue lock.
+ */
+inline void snrt_mcs_lock_release(snrt_mcs_lock_t *lock) {
+    snrt_mcs_node_t *node = &_snrt_mcs_node;
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    // If no successor is queued, try to free the lock
+    if (!node->next) {
+        snrt_mcs_node_t *expected = node;
+        if (__atomic_compare_exchange_n(&lock->tail, &expected, NULL, 0,
+                                        __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+            return;
+        // A successor is enqueuing, wait for it to link itself
+        while (!node->next)
+            ;
+    }
+    node->next->locked = 0;
+}
+
 //================================================================================
 // Barrier functions
 //================================================================================
@@ -168,71 +244,563 @@ inline uint32_t snrt_global_all_to_all_reduction(uint32_t value) {
 }
 
 /**
- * @brief Perform a sum reduction among clusters, blocking.
- * @details The reduction is performed in a logarithmic fashion. Half of the
+ * @brief Size of the chunks, in bytes, in which @ref
+ *        snrt_global_reduction_dma_generic pipelines its DMA transfers.
+ * @details Must be a multiple of 8 bytes, i.e. of the FPU's SIMD width.
+ */
+#ifndef SNRT_REDUCTION_CHUNK_SIZE
+#define SNRT_REDUCTION_CHUNK_SIZE 1024
+#endif
+
+#define _SNRT_REDUCTION_FREP(instr, n)                                   \
+    asm volatile("frep.o %[n_frep], 1, 0, 0 \n" instr " ft2, ft0, ft1\n" \
+                 :                                                       \
+                 : [ n_frep ] "r"((n)-1)                                 \
+                 : "ft0", "ft1", "ft2", "memory")
+
+#define _SNRT_REDUCTION_SCALAR(ld, st, instr, dst, src0, src1)      \
+    asm volatile(ld " ft3, 0(%[a])\n" ld " ft4, 0(%[b])\n" instr    \
+                    " ft3, ft3, ft4\n" st " ft3, 0(%[d])\n"         \
+                 :                                                  \
+                 : [ d ] "r"(dst), [ a ] "r"(src0), [ b ] "r"(src1) \
+                 : "ft3", "ft4", "memory")
+
+/**
+ * @brief Combine two arrays element-wise with a reduction operator.
+ * @details Computes `dst[i] = op(src0[i], src1[i])` for all `i < len`. The
+ *          bulk of the arrays is processed in 64-bit words, streamed through
+ *          the SSRs and reduced with packed-SIMD instructions, e.g. four FP16
+ *          additions per `vfadd.h`. Trailing elements which do not fill a
+ *          whole 64-bit word are processed with scalar instructions.
+ * @param dst Pointer to the destination array. May alias @p src0 or @p src1.
+ * @param src0 Pointer to the first source array.
+ * @param src1 Pointer to the second source array.
+ * @param len Number of elements in each array.
+ * @param prec Precision of the array elements.
+ * @param op The reduction operator.
+ * @note All arrays must be 8-byte aligned.
+ */
+inline void snrt_elementwise_reduction(void *dst, void *src0, void *src1,
+                                       size_t len, precision_t prec,
+                                       snrt_reduction_op_t op) {
+    size_t n_words = (len * prec) / sizeof(uint64_t);
+
+    // Reduce full 64-bit words with (packed-SIMD) FP instructions on SSRs
+    if (n_words) {
+        snrt_ssr_loop_1d(SNRT_SSR_DM_ALL, n_words, sizeof(uint64_t));
+        snrt_ssr_read(SNRT_SSR_DM0, SNRT_SSR_1D, src0);
+        snrt_ssr_read(SNRT_SSR_DM1, SNRT_SSR_1D, src1);
+        snrt_ssr_write(SNRT_SSR_DM2, SNRT_SSR_1D, dst);
+        snrt_ssr_enable();
+
+        switch (op) {
+            case SNRT_REDUCTION_SUM:
+                switch (prec) {
+                    case FP64:
+                        _SNRT_REDUCTION_FREP("fadd.d", n_words);
+                        break;
+                    case FP32:
+                        _SNRT_REDUCTION_FREP("vfadd.s", n_words);
+                        break;
+                    case FP16:
+                        _SNRT_REDUCTION_FREP("vfadd.h", n_words);
+                        break;
+                    case FP8:
+                        _SNRT_REDUCTION_FREP("vfadd.b", n_words);
+                        break;
+                }
+                break;
+            case SNRT_REDUCTION_MAX:
+                switch (prec) {
+                    case FP64:
+                        _SNRT_REDUCTION_FREP("fmax.d", n_words);
+                        break;
+                    case FP32:
+                        _SNRT_REDUCTION_FREP("vfmax.s", n_words);
+                        break;
+                    case FP16:
+                        _SNRT_REDUCTION_FREP("vfmax.h", n_words);
+                        break;
+                    case FP8:
+                        _SNRT_REDUCTION_FREP("vfmax.b", n_words);
+                        break;
+                }
+                break;
+            case SNRT_REDUCTION_MIN:
+                switch (prec) {
+                    case FP64:
+                        _SNRT_REDUCTION_FREP("fmin.d", n_words);
+                        break;
+                    case FP32:
+                        _SNRT_REDUCTION_FREP("vfmin.s", n_words);
+                        break;
+                    case FP16:
+                        _SNRT_REDUCTION_FREP("vfmin.h", n_words);
+                        break;
+                    case FP8:
+                        _SNRT_REDUCTION_FREP("vfmin.b", n_words);
+                        break;
+                }
+                break;
+        }
+
+        snrt_fpu_fence();
+        snrt_ssr_disable();
+    }
+
+    // Reduce trailing elements with scalar FP instructions
+    for (size_t i = n_words * sizeof(uint64_t); i < len * prec; i += prec) {
+        void *d = dst + i;
+        void *a = src0 + i;
+        void *b = src1 + i;
+        switch (op) {
+            case SNRT_REDUCTION_SUM:
+                switch (prec) {
+                    case FP32:
+                        _SNRT_REDUCTION_SCALAR("flw", "fsw", "fadd.s", d, a, b);
+                        break;
+                    case FP16:
+                        _SNRT_REDUCTION_SCALAR("flh", "fsh", "fadd.h", d, a, b);
+                        break;
+                    case FP8:
+                        _SNRT_REDUCTION_SCALAR("flb", "fsb", "fadd.b", d, a, b);
+                        break;
+                    default:
+                        break;
+                }
+                break;
+            case SNRT_REDUCTION_MAX:
+                switch (prec) {
+                    case FP32:
+                        _SNRT_REDUCTION_SCALAR("flw", "fsw", "fmax.s", d, a, b);
+                        break;
+                    case FP16:
+                        _SNRT_REDUCTION_SCALAR("flh", "fsh", "fmax.h", d, a, b);
+                        break;
+                    case FP8:
+                        _SNRT_REDUCTION_SCALAR("flb", "fsb", "fmax.b", d, a, b);
+                        break;
+                    default:
+                        break;
+                }
+                break;
+            case SNRT_REDUCTION_MIN:
+                switch (prec) {
+                    case FP32:
+                        _SNRT_REDUCTION_SCALAR("flw", "fsw", "fmin.s", d, a, b);
+                        break;
+                    case FP16:
+                        _SNRT_REDUCTION_SCALAR("flh", "fsh", "fmin.h", d, a, b);
+                        break;
+                    case FP8:
+                        _SNRT_REDUCTION_SCALAR("flb", "fsb", "fmin.b", d, a, b);
+                        break;
+                    default:
+                        break;
+                }
+                break;
+        }
+    }
+    snrt_fpu_fence();
+}
+
+/**
+ * @brief Perform a reduction among a group of clusters, blocking.
+ * @details The group consists of the clusters whose index is congruent to the
+ *          calling cluster's index modulo @p stride, i.e. the members of a
+ *          group are @p stride clusters apart. Every cluster belongs to
+ *          exactly one group, so disjoint groups can reduce concurrently.
+ *
+ *          The reduction is performed in a logarithmic fashion. Half of the
  *          clusters active in every level of the binary-tree participate as
  *          as senders, the other half as receivers. Senders use the DMA to
- *          send their data to the respective receiver's destination buffer.
- *          The receiver then reduces each element in its destination buffer
- *          with the respective element in its source buffer. It then proceeds
- *          to the next level in the binary tree.
+ *          send their partial result to the respective receiver's destination
+ *          buffer, which the receiver then combines with its own partial
+ *          result, before proceeding to the next level in the binary tree.
+ *
+ *          Transfers are split in chunks of @ref SNRT_REDUCTION_CHUNK_SIZE
+ *          bytes, so that the receiver's compute cores can reduce a chunk
+ *          while the next one is in flight. Senders and receivers synchronize
+ *          point-to-point through flags in their CLS: the receiver signals
+ *          its sender when its destination buffer is free to be written
+ *          (clear-to-send), and the sender signals the receiver every time a
+ *          chunk has landed. No global barrier is involved.
+ *
+ *          Within a cluster, every chunk is reduced in parallel by all
+ *          compute cores, using @ref snrt_elementwise_reduction.
  * @param dst_buffer The pointer to the calling cluster's destination buffer.
- * @param src_buffer The pointer to the calling cluster's source buffer.
- * @param len The amount of data in each buffer.
+ *                   On return, the buffer of the first member of the group
+ *                   holds the result of the reduction. In all other members
+ *                   it is used as scratch.
+ * @param src_buffer The pointer to the calling cluster's source buffer. Its
+ *                   contents are overwritten with intermediate results.
+ * @param len The number of elements in each buffer.
+ * @param prec The precision of the elements.
+ * @param op The reduction operator.
+ * @param stride The distance between the indices of two group members.
+ * @param num The number of clusters in the group.
  * @note The destination buffers must lie at the same offset in every cluster's
- *       TCDM.
+ *       TCDM, and both buffers must be 8-byte aligned.
+ * @note Every Snitch core in the group must invoke this function, or the
+ *       calling cores will stall indefinitely.
  */
-inline void snrt_global_reduction_dma(double *dst_buffer, double *src_buffer,
-                                      size_t len) {
+inline void snrt_group_reduction_dma_generic(void *dst_buffer,
+                                             void *src_buffer, size_t len,
+                                             precision_t prec,
+                                             snrt_reduction_op_t op,
+                                             uint32_t stride, uint32_t num) {
+    size_t size = len * prec;
+    uint32_t member = snrt_cluster_idx() / stride;
+
     // If we have a single cluster the reduction degenerates to a memcpy
-    if (snrt_cluster_num() == 1) {
+    if (num == 1) {
         if (!snrt_is_compute_core()) {
-            snrt_dma_start_1d(dst_buffer, src_buffer, len * sizeof(double));
+            snrt_dma_start_1d(dst_buffer, src_buffer, size);
             snrt_dma_wait_all();
         }
         snrt_cluster_hw_barrier();
-    } else {
-        // Iterate levels in the binary reduction tree
-        int num_levels = ceil(log2(snrt_cluster_num()));
-        for (unsigned int level = 0; level < num_levels; level++) {
-            // Determine whether the current cluster is an active cluster.
-            // An active cluster is a cluster that participates in the current
-            // level of the reduction tree. Every second cluster among the
-            // active ones is a sender.
-            uint32_t is_active = (snrt_cluster_idx() % (1 << level)) == 0;
-            uint32_t is_sender = (snrt_cluster_idx() % (1 << (level + 1))) != 0;
-
-            // If the cluster is a sender, it sends the data in its source
-            // buffer to the respective receiver's destination buffer
-            if (is_active && is_sender) {
-                if (!snrt_is_compute_core()) {
-                    void *dst =
-                        (void *)dst_buffer - (1 << level) * SNRT_CLUSTER_OFFSET;
-                    snrt_dma_start_1d(dst, src_buffer, len * sizeof(double));
-                    snrt_dma_wait_all();
+        return;
+    }
+
+    uint32_t n_chunks =
+        (size + SNRT_REDUCTION_CHUNK_SIZE - 1) / SNRT_REDUCTION_CHUNK_SIZE;
+
+    // Iterate levels in the binary reduction tree
+    int num_levels = ceil(log2(num));
+    for (unsigned int level = 0; level < num_levels; level++) {
+        // Determine whether the current cluster is an active cluster.
+        // An active cluster is a cluster that participates in the current
+        // level of the reduction tree. Every second cluster among the
+        // active ones is a sender. Clusters which are not active in a level
+        // will not be active in any successive level.
+        uint32_t distance = 1 << level;
+        uint32_t is_active = (member % distance) == 0;
+        uint32_t is_sender = (member % (2 * distance)) != 0;
+        if (!is_active) break;
+
+        // If the cluster is a sender, it sends the data in its source
+        // buffer to the respective receiver's destination buffer
+        if (is_sender) {
+            if (snrt_is_dm_core()) {
+                uint32_t offset = distance * stride * SNRT_CLUSTER_OFFSET;
+                void *dst = dst_buffer - offset;
+                volatile uint32_t *seq =
+                    (volatile uint32_t *)((uint32_t)&cls()->reduction_seq -
+                                          offset);
+
+                // Wait for the receiver to be ready. The clear-to-send flag
+                // carries the sequence number of the receiver's next chunk.
+                while (!cls()->reduction_cts)
+                    ;
+                uint32_t next_seq = cls()->reduction_cts;
+                cls()->reduction_cts = 0;
+
+                // Keep two chunks in flight, and notify the receiver as
+                // soon as each chunk lands
+                snrt_dma_txid_t txid[2];
+                for (uint32_t i = 0; i < n_chunks + 1; i++) {
+                    if (i < n_chunks) {
+                        size_t chunk_offset = i * SNRT_REDUCTION_CHUNK_SIZE;
+                        size_t chunk_size = size - chunk_offset;
+                        if (chunk_size > SNRT_REDUCTION_CHUNK_SIZE)
+                            chunk_size = SNRT_REDUCTION_CHUNK_SIZE;
+                        txid[i % 2] =
+                            snrt_dma_start_1d(dst + chunk_offset,
+                                              src_buffer + chunk_offset,
+                                              chunk_size);
+                    }
+                    if (i > 0) {
+                        snrt_dma_wait(txid[(i - 1) % 2]);
+                        *seq = next_seq + i - 1;
+                    }
                 }
             }
+            break;
+        }
 
-            // Synchronize senders and receivers
-            snrt_global_barrier();
+        // Every cluster which is not a sender performs the reduction, if it
+        // has a partner in the current level
+        if ((member + distance) < num) {
+            uint32_t next_seq = _snrt_reduction_chunks + 1;
 
-            // Every cluster which is not a sender performs the reduction
-            if (is_active && !is_sender) {
-                // Computation is parallelized over the compute cores
-                if (snrt_is_compute_core()) {
-                    uint32_t items_per_core =
-                        len / snrt_cluster_compute_core_num();
+            // The DM core signals the sender that the destination buffer can
+            // be overwritten
+            if (snrt_is_dm_core()) {
+                volatile uint32_t *cts =
+                    (volatile uint32_t *)((uint32_t)&cls()->reduction_cts +
+                                          distance * stride *
+                                              SNRT_CLUSTER_OFFSET);
+                *cts = next_seq;
+            }
+            // Computation is parallelized over the compute cores. In the
+            // last level the result is written to the destination buffer.
+            else {
+                void *result = (level == num_levels - 1) ? dst_buffer
+                                                         : src_buffer;
+                uint32_t core_idx = snrt_cluster_core_idx();
+                uint32_t core_num = snrt_cluster_compute_core_num();
+                for (uint32_t i = 0; i < n_chunks; i++) {
+                    // Split the chunk in 64-bit words among the cores.
+                    // Trailing elements are assigned to the last core.
+                    size_t chunk_offset = i * SNRT_REDUCTION_CHUNK_SIZE;
+                    size_t chunk_size = size - chunk_offset;
+                    if (chunk_size > SNRT_REDUCTION_CHUNK_SIZE)
+                        chunk_size = SNRT_REDUCTION_CHUNK_SIZE;
+                    uint32_t n_words = chunk_size / sizeof(uint64_t);
+                    uint32_t words_per_core = n_words / core_num;
+                    uint32_t rem_words = n_words % core_num;
+                    uint32_t core_words =
+                        words_per_core + (core_idx < rem_words);
+                    uint32_t core_word_offset =
+                        core_idx * words_per_core +
+                        (core_idx < rem_words ? core_idx : rem_words);
                     uint32_t core_offset =
-                        snrt_cluster_core_idx() * items_per_core;
-                    for (uint32_t i = 0; i < items_per_core; i++) {
-                        uint32_t abs_i = core_offset + i;
-                        dst_buffer[abs_i] += src_buffer[abs_i];
-                    }
+                        chunk_offset + core_word_offset * sizeof(uint64_t);
+                    uint32_t core_len = core_words * sizeof(uint64_t) / prec;
+                    if (core_idx == core_num - 1)
+                        core_len += (chunk_size % sizeof(uint64_t)) / prec;
+
+                    // Wait for the chunk to land
+                    while ((int32_t)(cls()->reduction_seq - (next_seq + i)) <
+                           0)
+                        ;
+
+                    if (core_len)
+                        snrt_elementwise_reduction(
+                            result + core_offset, src_buffer + core_offset,
+                            dst_buffer + core_offset, core_len, prec, op);
                 }
             }
+            _snrt_reduction_chunks += n_chunks;
 
             // Synchronize compute and DM cores for next tree level
             snrt_cluster_hw_barrier();
         }
     }
+
+    // Synchronize compute and DM cores on exit
+    snrt_cluster_hw_barrier();
+}
+
+/**
+ * @brief Perform a reduction among all clusters, blocking.
+ * @details See @ref snrt_group_reduction_dma_generic. On return, cluster 0's
+ *          destination buffer holds the result of the reduction.
+ * @note Every Snitch core must invoke this function, or the calling cores
+ *       will stall indefinitely.
+ */
+inline void snrt_global_reduction_dma_generic(void *dst_buffer,
+                                              void *src_buffer, size_t len,
+                                              precision_t prec,
+                                              snrt_reduction_op_t op) {
+    snrt_group_reduction_dma_generic(dst_buffer, src_buffer, len, prec, op, 1,
+                                     snrt_cluster_num());
+}
+
+/**
+ * @brief Perform a sum reduction among clusters, blocking.
+ * @details Specialization of @ref snrt_global_reduction_dma_generic for
+ *          FP64 sum reductions.
+ * @param dst_buffer The pointer to the calling cluster's destination buffer.
+ * @param src_buffer The pointer to the calling cluster's source buffer.
+ * @param len The amount of data in each buffer.
+ * @note The destination buffers must lie at the same offset in every cluster's
+ *       TCDM.
+ */
+inline void snrt_global_reduction_dma(double *dst_buffer, double *src_buffer,
+                                      size_t len) {
+    snrt_global_reduction_dma_generic(dst_buffer, src_buffer, len, FP64,
+                                      SNRT_REDUCTION_SUM);
+}
+
+//================================================================================
+// Broadcast and gather functions
+//================================================================================
+
+/**
+ * @brief Size of the chunks, in bytes, in which @ref snrt_broadcast
+ *        pipelines its DMA transfers.
+ */
+#ifndef SNRT_BROADCAST_CHUNK_SIZE
+#define SNRT_BROADCAST_CHUNK_SIZE 2048
+#endif
+
+/**
+ * @brief Get a pointer to a variable in another cluster's CLS.
+ * @param ptr Pointer to the variable in the calling cluster's CLS.
+ * @param cluster_idx Index of the target cluster.
+ */
+inline volatile uint32_t *snrt_remote_cls_ptr(volatile uint32_t *ptr,
+                                              uint32_t cluster_idx) {
+    return (volatile uint32_t *)((uint32_t)ptr +
+                                 (cluster_idx - snrt_cluster_idx()) *
+                                     SNRT_CLUSTER_OFFSET);
+}
+
+/**
+ * @brief Broadcast a buffer to all clusters, blocking.
+ * @details The source buffer is fetched only once, by cluster 0, and then
+ *          forwarded cluster to cluster along a chain, from the TCDM of
+ *          every cluster to the TCDM of the next. Transfers are split in
+ *          chunks of @ref SNRT_BROADCAST_CHUNK_SIZE bytes, so that a cluster
+ *          can forward a chunk while it receives the next one.
+ *
+ *          Neighbouring clusters synchronize point-to-point through flags in
+ *          their CLS: every cluster signals its predecessor when its
+ *          destination buffer is free to be written, and the predecessor
+ *          signals it every time a chunk has landed.
+ * @param dst_buffer The pointer to the calling cluster's destination buffer.
+ * @param src The pointer to the source buffer, e.g. in L3. Only accessed by
+ *            cluster 0.
+ * @param size The size of the buffer in bytes.
+ * @note The destination buffers must lie at the same offset in every cluster's
+ *       TCDM.
+ * @note Every Snitch core must invoke this function, or the calling cores
+ *       will stall indefinitely.
+ */
+inline void snrt_broadcast(void *dst_buffer, const void *src, size_t size) {
+    if (snrt_is_dm_core()) {
+        uint32_t cluster_idx = snrt_cluster_idx();
+        uint32_t has_pred = cluster_idx > 0;
+        uint32_t has_succ = cluster_idx < (snrt_cluster_num() - 1);
+        uint32_t n_chunks =
+            (size + SNRT_BROADCAST_CHUNK_SIZE - 1) / SNRT_BROADCAST_CHUNK_SIZE;
+        uint32_t next_seq = _snrt_ring_chunks + 1;
+        uint32_t succ_seq;
+        void *succ_dst_buffer = dst_buffer + SNRT_CLUSTER_OFFSET;
+        volatile uint32_t *succ_ring_seq =
+            snrt_remote_cls_ptr(&cls()->ring_seq, cluster_idx + 1);
+
+        // Signal the predecessor that the destination buffer can be
+        // overwritten. The clear-to-send flag carries the sequence number of
+        // the next chunk we expect.
+        if (has_pred) {
+            *snrt_remote_cls_ptr(&cls()->ring_cts, cluster_idx - 1) = next_seq;
+        }
+
+        // Wait for the successor to be ready
+        if (has_succ) {
+            while (!cls()->ring_cts)
+                ;
+            succ_seq = cls()->ring_cts;
+            cls()->ring_cts = 0;
+        }
+
+        snrt_dma_txid_t prev_txid;
+        for (uint32_t i = 0; i < n_chunks; i++) {
+            size_t chunk_offset = i * SNRT_BROADCAST_CHUNK_SIZE;
+            size_t chunk_size = size - chunk_offset;
+            if (chunk_size > SNRT_BROADCAST_CHUNK_SIZE)
+                chunk_size = SNRT_BROADCAST_CHUNK_SIZE;
+
+            // Cluster 0 fetches the chunk from the source, all other
+            // clusters wait for it to be forwarded by their predecessor
+            if (!has_pred) {
+                snrt_dma_wait(snrt_dma_start_1d(dst_buffer + chunk_offset,
+                                                src + chunk_offset,
+                                                chunk_size));
+            } else {
+                while ((int32_t)(cls()->ring_seq - (next_seq + i)) < 0)
+                    ;
+            }
+
+            // Forward the chunk to the successor, and notify it when the
+            // previous chunk has landed
+            if (has_succ) {
+                snrt_dma_txid_t txid =
+                    snrt_dma_start_1d(succ_dst_buffer + chunk_offset,
+                                      dst_buffer + chunk_offset, chunk_size);
+                if (i > 0) {
+                    snrt_dma_wait(prev_txid);
+                    *succ_ring_seq = succ_seq + i - 1;
+                }
+                prev_txid = txid;
+            }
+        }
+        if (has_succ && n_chunks) {
+            snrt_dma_wait(prev_txid);
+            *succ_ring_seq = succ_seq + n_chunks - 1;
+        }
+
+        if (has_pred) _snrt_ring_chunks += n_chunks;
+    }
+
+    // Make the data visible to all cores in the cluster
+    snrt_cluster_hw_barrier();
+}
+
+/**
+ * @brief Gather a buffer from every cluster into all clusters, blocking.
+ * @details Every cluster first copies its own contribution into its
+ *          destination buffer, at the offset corresponding to its cluster
+ *          index. The contributions are then forwarded along a ring, where in
+ *          every step each cluster sends the most recently received
+ *          contribution to its successor. After `snrt_cluster_num() - 1`
+ *          steps every cluster holds all contributions.
+ *
+ *          Neighbouring clusters synchronize point-to-point through flags in
+ *          their CLS, as in @ref snrt_broadcast.
+ * @param dst_buffer The pointer to the calling cluster's destination buffer.
+ *                   Must be large enough to hold `snrt_cluster_num() * size`
+ *                   bytes. On return, it holds the contribution of cluster
+ *                   `i` at byte offset `i * size`.
+ * @param src The pointer to the calling cluster's contribution, e.g. in L3.
+ * @param size The size of every cluster's contribution in bytes.
+ * @note The destination buffers must lie at the same offset in every cluster's
+ *       TCDM.
+ * @note Every Snitch core must invoke this function, or the calling cores
+ *       will stall indefinitely.
+ */
+inline void snrt_allgather(void *dst_buffer, const void *src, size_t size) {
+    if (snrt_is_dm_core()) {
+        uint32_t cluster_idx = snrt_cluster_idx();
+        uint32_t cluster_num = snrt_cluster_num();
+        uint32_t pred = (cluster_idx + cluster_num - 1) % cluster_num;
+        uint32_t succ = (cluster_idx + 1) % cluster_num;
+        uint32_t next_seq = _snrt_ring_chunks + 1;
+        void *succ_dst_buffer =
+            dst_buffer + (succ - cluster_idx) * SNRT_CLUSTER_OFFSET;
+        volatile uint32_t *succ_ring_seq =
+            snrt_remote_cls_ptr(&cls()->ring_seq, succ);
+
+        // Copy own contribution
+        snrt_dma_txid_t txid = snrt_dma_start_1d(
+            dst_buffer + cluster_idx * size, src, size);
+
+        if (cluster_num > 1) {
+            // Signal the predecessor that the destination buffer can be
+            // overwritten, and wait for the successor to be ready
+            *snrt_remote_cls_ptr(&cls()->ring_cts, pred) = next_seq;
+            while (!cls()->ring_cts)
+                ;
+            uint32_t succ_seq = cls()->ring_cts;
+            cls()->ring_cts = 0;
+            snrt_dma_wait(txid);
+
+            // In step i, forward the contribution of cluster `idx - i`,
+            // which was received in the previous step
+            for (uint32_t i = 0; i < cluster_num - 1; i++) {
+                size_t offset =
+                    ((cluster_idx + cluster_num - i) % cluster_num) * size;
+                if (i > 0) {
+                    while ((int32_t)(cls()->ring_seq - (next_seq + i - 1)) < 0)
+                        ;
+                }
+                snrt_dma_wait(snrt_dma_start_1d(succ_dst_buffer + offset,
+                                                dst_buffer + offset, size));
+                *succ_ring_seq = succ_seq + i;
+            }
+
+            // Wait for the last contribution to land
+            while ((int32_t)(cls()->ring_seq - (next_seq + cluster_num - 2)) <
+                   0)
+                ;
+            _snrt_ring_chunks += cluster_num - 1;
+        } else {
+            snrt_dma_wait(txid);
+        }
+    }
+
+    // Make the data visible to all cores in the cluster
+    snrt_cluster_hw_barrier();
 }
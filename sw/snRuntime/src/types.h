@@ -2,7 +2,19 @@
 // Licensed under the Apache License, Version 2.0, see LICENSE for details.
 // SPDX-License-Identifier: Apache-2.0
 
-typedef enum { FP64 = 8, FP32 = 4, FP16 = 2, FP8 = 1 } precision_t;
+#pragma once
+
+// The lower four bits of a precision hold the size of its elements in bytes.
+// Integer precisions are additionally flagged by bit 4.
+typedef enum {
+    FP64 = 8,
+    FP32 = 4,
+    FP16 = 2,
+    FP8 = 1,
+    INT32 = 0x14,
+    INT16 = 0x12,
+    INT8 = 0x11
+} precision_t;
 
 typedef float v2f32 __attribute__((vector_size(8)));
 typedef __fp16 v4f16 __attribute__((vector_size(8)));
@@ -0,0 +1,30 @@
+// Copyright 2024 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "snrt.h"
+
+#define LEN 100
+
+int main() {
+    uint32_t errors = 0;
+    uint32_t cluster_idx = snrt_cluster_idx();
+
+    // Every cluster contributes a buffer from its own TCDM
+    uint32_t *dst = (uint32_t *)snrt_l1_next();
+    uint32_t *src = dst + snrt_cluster_num() * LEN;
+    if (snrt_is_dm_core()) {
+        for (uint32_t i = 0; i < LEN; i++) src[i] = cluster_idx * LEN + i;
+    }
+    snrt_cluster_hw_barrier();
+
+    snrt_allgather(dst, src, LEN * sizeof(uint32_t));
+
+    // Every cluster checks that it received all contributions
+    if (snrt_cluster_core_idx() == 0) {
+        for (uint32_t i = 0; i < snrt_cluster_num() * LEN; i++)
+            errors += (dst[i] != i);
+    }
+
+    return errors;
+}
@@ -2,7 +2,8 @@
 // Licensed under the Apache License, Version 2.0, see LICENSE for details.
 // SPDX-License-Identifier: Apache-2.0
 
-/* Tests that a single core can do atomics */
+/* Tests that a single core can do atomics, and benchmarks the runtime locks
+ * under contention from the compute cores of a cluster */
 
 #include <snrt.h>
 
@@ -172,6 +173,106 @@ uint32_t test_atomics(volatile uint32_t* atomic_var) {
     return nerrors;
 }
 
+//===============================================================
+// Lock contention benchmark (all cores)
+//===============================================================
+
+#define LOCK_ITERS 16
+
+typedef enum {
+    LOCK_TAS,
+    LOCK_TTAS,
+    LOCK_TICKET,
+    LOCK_MCS,
+    NUM_LOCK_TYPES
+} lock_type_t;
+
+static const char* lock_names[NUM_LOCK_TYPES] = {"tas", "ttas", "ticket",
+                                                 "mcs"};
+
+typedef struct {
+    volatile uint32_t mutex;
+    snrt_ticket_lock_t ticket;
+    snrt_mcs_lock_t mcs;
+    // Shared data protected by the lock under test
+    volatile uint32_t counter;
+    // Cycles spent in the acquire function, summed over all cores
+    volatile uint32_t acquire_cycles;
+} lock_bench_t;
+
+static inline void lock_acquire(lock_bench_t* bench, lock_type_t type) {
+    switch (type) {
+        case LOCK_TAS:
+            snrt_mutex_acquire(&bench->mutex);
+            break;
+        case LOCK_TTAS:
+            snrt_mutex_ttas_acquire(&bench->mutex);
+            break;
+        case LOCK_TICKET:
+            snrt_ticket_lock_acquire(&bench->ticket);
+            break;
+        default:
+            snrt_mcs_lock_acquire(&bench->mcs);
+            break;
+    }
+}
+
+static inline void lock_release(lock_bench_t* bench, lock_type_t type) {
+    switch (type) {
+        case LOCK_TAS:
+        case LOCK_TTAS:
+            snrt_mutex_release(&bench->mutex);
+            break;
+        case LOCK_TICKET:
+            snrt_ticket_lock_release(&bench->ticket);
+            break;
+        default:
+            snrt_mcs_lock_release(&bench->mcs);
+            break;
+    }
+}
+
+// Let `num_cores` compute cores contend for the lock and report the average
+// acquire latency (in cycles) and the throughput (in acquisitions per 1000
+// cycles). Returns the number of lost updates to the shared counter.
+uint32_t benchmark_lock(lock_bench_t* bench, lock_type_t type,
+                        uint32_t num_cores) {
+    uint32_t core_idx = snrt_cluster_core_idx();
+    uint32_t nerrors = 0;
+
+    if (core_idx == 0) {
+        bench->counter = 0;
+        bench->acquire_cycles = 0;
+    }
+    snrt_cluster_hw_barrier();
+
+    uint32_t start = snrt_mcycle();
+    if (snrt_is_compute_core() && core_idx < num_cores) {
+        uint32_t acquire_cycles = 0;
+        for (int i = 0; i < LOCK_ITERS; i++) {
+            uint32_t t0 = snrt_mcycle();
+            lock_acquire(bench, type);
+            acquire_cycles += snrt_mcycle() - t0;
+            bench->counter++;
+            lock_release(bench, type);
+        }
+        __atomic_fetch_add(&bench->acquire_cycles, acquire_cycles,
+                           __ATOMIC_RELAXED);
+    }
+    snrt_cluster_hw_barrier();
+    uint32_t cycles = snrt_mcycle() - start;
+
+    if (core_idx == 0) {
+        uint32_t total = num_cores * LOCK_ITERS;
+        if (bench->counter != total) nerrors++;
+        if (snrt_cluster_idx() == 0)
+            printf("[lock] %s cores=%u latency=%u throughput=%u\n",
+                   lock_names[type], num_cores, bench->acquire_cycles / total,
+                   total * 1000 / cycles);
+    }
+    return nerrors;
+}
+
 // Use at least two locations to test unaligned accesses
 #define NUM_SPM_LOCATIONS 2
 #define NUM_TCDM_LOCATIONS 2
@@ -197,9 +298,25 @@ int main() {
         for (int i = 0; i < NUM_SPM_LOCATIONS; ++i) {
             nerrors += test_atomics(&l3_a[i]);
         }
-    } else {
-        return 0;
     }
+    snrt_cluster_hw_barrier();
 
-    return nerrors;
+    // All cores share the lock state, allocated in TCDM
+    lock_bench_t* bench = (lock_bench_t*)snrt_l1_next();
+    snrt_cluster_hw_barrier();
+    if (core_id == 0) {
+        snrt_l1_alloc(sizeof(lock_bench_t));
+        bench->mutex = 0;
+        bench->ticket.next = 0;
+        bench->ticket.serving = 0;
+        bench->mcs.tail = NULL;
+    }
+
+    for (int type = 0; type < NUM_LOCK_TYPES; type++) {
+        for (uint32_t n = 1; n <= snrt_cluster_compute_core_num(); n *= 2) {
+            nerrors += benchmark_lock(bench, type, n);
+        }
+    }
+
+    return core_id == 0 ? nerrors : 0;
 }
@@ -0,0 +1,31 @@
+// Copyright 2024 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "snrt.h"
+
+// Spans multiple broadcast chunks
+#define LEN 1000
+
+uint32_t src[LEN];
+
+int main() {
+    uint32_t errors = 0;
+
+    // Initialize source buffer in L3
+    if (snrt_global_core_idx() == 0) {
+        for (uint32_t i = 0; i < LEN; i++) src[i] = i;
+    }
+    snrt_global_barrier();
+
+    // Broadcast to a buffer at the same offset in every cluster's TCDM
+    uint32_t *dst = (uint32_t *)snrt_l1_next();
+    snrt_broadcast(dst, src, LEN * sizeof(uint32_t));
+
+    // Every cluster checks its own copy
+    if (snrt_cluster_core_idx() == 0) {
+        for (uint32_t i = 0; i < LEN; i++) errors += (dst[i] != i);
+    }
+
+    return errors;
+}
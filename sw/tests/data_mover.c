@@ -6,6 +6,14 @@
 
 volatile static uint32_t sum = 0;
 
+// Number of tasks each compute core enqueues in the contention benchmark
+#define N_CONTENTION_TASKS 16
+
+static snrt_barrier_t compute_barrier;
+static uint32_t *volatile contention_src;
+static uint32_t *volatile contention_dst;
+static volatile uint32_t enqueue_cycles;
+
 uint32_t compare(uint32_t *a, uint32_t *b, uint32_t n) {
     uint32_t mismatch = 0;
     for (uint32_t i = 0; i < n; ++i) {
@@ -16,25 +24,9 @@ uint32_t compare(uint32_t *a, uint32_t *b, uint32_t n) {
     return mismatch;
 }
 
-int main() {
-    unsigned core_idx = snrt_cluster_core_idx();
-    unsigned core_num = snrt_cluster_core_num();
+// Single-hart tests, run by core 0 only
+static unsigned single_core_tests(void) {
     unsigned err = 0, mismatch;
-    static unsigned arg = 0;
-
-    dm_init();
-
-    if (core_idx == 0) {
-        // Wait for DM to be ready
-        dm_wait_ready();
-    } else if (snrt_is_dm_core()) {
-        // Put DM core in its event loop
-        dm_main();
-        return 0;
-    } else {
-        // all other cores exit, this is a single-hart test
-        return 0;
-    }
 
     // Prepare data buffers
     const uint32_t n_elem = 128, n_rep = 4;
@@ -96,6 +88,78 @@ int main() {
         err |= 1 << 4;
     }
 
+    printf("-- Test 5: Per-transfer wait\n");
+    for (uint32_t i = 0; i < n_elem; ++i) l1_a[i] = i + 5;
+    for (uint32_t i = 0; i < n_elem; ++i) l1_c[i] = i + 6;
+    dm_txid_t txid_b = dm_memcpy_async(l1_b, l1_a, n_elem * sizeof(uint32_t));
+    dm_txid_t txid_d = dm_memcpy_async(l1_d, l1_c, n_elem * sizeof(uint32_t));
+    dm_wait_txid(txid_b);
+    mismatch = compare(l1_a, l1_b, n_elem);
+    dm_wait_txid(txid_d);
+    mismatch += compare(l1_c, l1_d, n_elem);
+    if (mismatch) {
+        printf("  failed with %d mismatches\n", mismatch);
+        err |= 1 << 5;
+    }
+
+    return err;
+}
+
+int main() {
+    unsigned core_idx = snrt_cluster_core_idx();
+    unsigned core_num = snrt_cluster_core_num();
+    unsigned compute_num = snrt_cluster_compute_core_num();
+    unsigned err = 0, mismatch;
+
+    dm_init();
+
+    if (snrt_is_dm_core()) {
+        // Put DM core in its event loop
+        dm_main();
+        return 0;
+    }
+
+    if (core_idx == 0) {
+        // Wait for DM to be ready
+        dm_wait_ready();
+
+        err = single_core_tests();
+
+        printf("-- Test 6: Enqueue latency under contention\n");
+        contention_src = snrt_l1_alloc(N_CONTENTION_TASKS * sizeof(uint32_t));
+        contention_dst =
+            snrt_l1_alloc(compute_num * N_CONTENTION_TASKS * sizeof(uint32_t));
+        for (uint32_t i = 0; i < N_CONTENTION_TASKS; ++i)
+            contention_src[i] = i + 5;
+        enqueue_cycles = 0;
+    }
+
+    // All compute cores enqueue small transfers at the same time
+    snrt_partial_barrier(&compute_barrier, compute_num);
+    uint32_t *dst = contention_dst + core_idx * N_CONTENTION_TASKS;
+    dm_txid_t txid;
+    uint32_t start = snrt_mcycle();
+    for (uint32_t i = 0; i < N_CONTENTION_TASKS; ++i)
+        txid = dm_memcpy_async(&dst[i], &contention_src[i], sizeof(uint32_t));
+    uint32_t cycles = snrt_mcycle() - start;
+    __atomic_add_fetch(&enqueue_cycles, cycles, __ATOMIC_RELAXED);
+    // Transfers complete in order, so waiting for the last one is enough
+    dm_wait_txid(txid);
+    snrt_partial_barrier(&compute_barrier, compute_num);
+    if (core_idx != 0) return 0;
+
+    printf("  %d cores, avg enqueue latency: %d cycles\n", compute_num,
+           enqueue_cycles / (compute_num * N_CONTENTION_TASKS));
+    mismatch = 0;
+    for (uint32_t c = 0; c < compute_num; ++c)
+        mismatch += compare(contention_src,
+                            contention_dst + c * N_CONTENTION_TASKS,
+                            N_CONTENTION_TASKS);
+    if (mismatch) {
+        printf("  failed with %d mismatches\n", mismatch);
+        err |= 1 << 6;
+    }
+
     // exit
     dm_exit();
     return err;
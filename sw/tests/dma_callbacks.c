@@ -0,0 +1,68 @@
+// Copyright 2023 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <snrt.h>
+
+#define NUM_TRANSFERS 4
+#define TRANSFER_LEN 64
+
+// Allocate a buffer in the main memory which we will use to copy data around
+// with the DMA.
+uint32_t buffer[NUM_TRANSFERS * TRANSFER_LEN];
+
+typedef struct {
+    uint32_t idx;
+    uint32_t *dst;
+    uint32_t *src;
+    uint32_t *order;
+    uint32_t *errors;
+} transfer_t;
+
+static uint32_t num_completed;
+
+// Check the transfer data and record in which order callbacks were invoked.
+void check_transfer(void *arg) {
+    transfer_t *transfer = (transfer_t *)arg;
+    for (uint32_t i = 0; i < TRANSFER_LEN; i++)
+        *transfer->errors += transfer->dst[i] != transfer->src[i];
+    transfer->order[num_completed++] = transfer->idx;
+}
+
+void count_idle(void *arg) { (*(uint32_t *)arg)++; }
+
+int main() {
+    if (!snrt_is_dm_core() || snrt_cluster_idx() != 0) return 0;
+    uint32_t errors = 0;
+
+    uint32_t src[NUM_TRANSFERS * TRANSFER_LEN];
+    for (uint32_t i = 0; i < NUM_TRANSFERS * TRANSFER_LEN; i++) src[i] = i;
+
+    // Register a callback for every transfer
+    transfer_t transfers[NUM_TRANSFERS];
+    uint32_t order[NUM_TRANSFERS];
+    snrt_dma_txid_t tid;
+    for (uint32_t t = 0; t < NUM_TRANSFERS; t++) {
+        transfers[t] = (transfer_t){t, &buffer[t * TRANSFER_LEN],
+                                    &src[t * TRANSFER_LEN], order, &errors};
+        tid = snrt_dma_start_1d(transfers[t].dst, transfers[t].src,
+                                TRANSFER_LEN * sizeof(uint32_t));
+        errors += snrt_dma_on_complete(tid, check_transfer, &transfers[t]);
+    }
+
+    // Wait on the last transfer, all callbacks must have run in order
+    uint32_t idle_count = 0;
+    snrt_dma_wait_yield(tid, count_idle, &idle_count);
+    errors += num_completed != NUM_TRANSFERS;
+    for (uint32_t t = 0; t < num_completed; t++) errors += order[t] != t;
+    errors += snrt_dma_poll() != 0;
+    printf("[dma_callbacks] idle iterations: %u\n", idle_count);
+
+    // The registry is bounded
+    for (uint32_t i = 0; i < SNRT_DMA_MAX_CALLBACKS; i++)
+        errors += snrt_dma_on_complete(tid, count_idle, &idle_count);
+    errors += snrt_dma_on_complete(tid, count_idle, &idle_count) != -1;
+    errors += snrt_dma_poll() != 0;
+
+    return errors;
+}
@@ -0,0 +1,40 @@
+// Copyright 2023 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <snrt.h>
+
+#define SIZE 4096
+
+// Source buffer in main memory
+uint8_t buffer[SIZE];
+
+int main() {
+    if (!snrt_is_dm_core() || snrt_cluster_idx() != 0) return 0;
+    uint32_t errors = 0;
+
+    uint8_t *dst = snrt_l1_alloc(SIZE);
+    for (uint32_t i = 0; i < SIZE; i++) buffer[i] = i;
+
+    // Nothing is reported before the statistics are started
+    snrt_dma_stats_t stats;
+    snrt_dma_stats_get(&stats, 0);
+    errors += stats.bytes != 0 || stats.cycles != 0;
+
+    snrt_dma_stats_start(1);
+    snrt_dma_wait(snrt_dma_start_1d(dst, buffer, SIZE));
+    snrt_dma_stats_get(&stats, 0);
+    snrt_dma_stats_dump();
+
+    // All bytes were written within the busy cycles, in at least one burst
+    errors += stats.bytes != SIZE;
+    errors += stats.bursts == 0;
+    errors += stats.busy == 0 || stats.busy > stats.cycles;
+
+    // Restarting clears the statistics
+    snrt_dma_stats_start(1);
+    snrt_dma_stats_get(&stats, 0);
+    errors += stats.bytes != 0;
+
+    return errors;
+}
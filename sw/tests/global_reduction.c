@@ -0,0 +1,53 @@
+// Copyright 2024 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "snrt.h"
+
+// Spans multiple reduction chunks and is not a multiple of the core count
+#define LEN_FP64 301
+// Leaves a trailing element which does not fill a 64-bit word
+#define LEN_FP32 101
+
+int main() {
+    uint32_t errors = 0;
+    uint32_t cluster_idx = snrt_cluster_idx();
+    uint32_t cluster_num = snrt_cluster_num();
+
+    // Buffers lie at the same offset in every cluster's TCDM
+    double *dst = (double *)snrt_l1_next();
+    double *src = dst + LEN_FP64;
+
+    // Test 1: FP64 sum
+    if (snrt_is_dm_core()) {
+        for (uint32_t i = 0; i < LEN_FP64; i++) src[i] = cluster_idx + i;
+    }
+    snrt_cluster_hw_barrier();
+    snrt_global_reduction_dma(dst, src, LEN_FP64);
+    if (cluster_idx == 0 && snrt_cluster_core_idx() == 0) {
+        for (uint32_t i = 0; i < LEN_FP64; i++) {
+            double golden =
+                cluster_num * i + cluster_num * (cluster_num - 1) / 2;
+            errors += (dst[i] != golden);
+        }
+    }
+    snrt_global_barrier();
+
+    // Test 2: FP32 max
+    float *dst_fp32 = (float *)dst;
+    float *src_fp32 = (float *)src;
+    if (snrt_is_dm_core()) {
+        for (uint32_t i = 0; i < LEN_FP32; i++)
+            src_fp32[i] = (float)(cluster_idx * i);
+    }
+    snrt_cluster_hw_barrier();
+    snrt_global_reduction_dma_generic(dst_fp32, src_fp32, LEN_FP32, FP32,
+                                      SNRT_REDUCTION_MAX);
+    if (cluster_idx == 0 && snrt_cluster_core_idx() == 0) {
+        for (uint32_t i = 0; i < LEN_FP32; i++) {
+            errors += (dst_fp32[i] != (float)((cluster_num - 1) * i));
+        }
+    }
+
+    return errors;
+}
@@ -0,0 +1,106 @@
+// Copyright 2023 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+// Checks `snrt_memcpy` and `snrt_memset`, and measures the crossover point
+// between the CPU and DMA implementations, both on the DM core and on a
+// compute core delegating to the data mover.
+
+#include <snrt.h>
+
+#define MIN_SIZE 32
+#define MAX_SIZE 8192
+
+static uint8_t *src;
+static uint8_t *dst;
+
+static uint32_t check_memcpy(size_t offset, size_t n) {
+    uint32_t errors = 0;
+    snrt_memset_cpu(dst, 0xAA, MAX_SIZE);
+    snrt_memcpy(dst + offset, src, n);
+    for (size_t i = 0; i < MAX_SIZE; i++) {
+        uint8_t expected =
+            (i >= offset && i < offset + n) ? src[i - offset] : 0xAA;
+        errors += dst[i] != expected;
+    }
+    return errors;
+}
+
+static uint32_t check_memset(size_t offset, size_t n, int value) {
+    uint32_t errors = 0;
+    snrt_memset_cpu(dst, 0xAA, MAX_SIZE);
+    snrt_memset(dst + offset, value, n);
+    for (size_t i = 0; i < MAX_SIZE; i++) {
+        uint8_t expected =
+            (i >= offset && i < offset + n) ? (uint8_t)value : 0xAA;
+        errors += dst[i] != expected;
+    }
+    return errors;
+}
+
+// Check both implementations, with aligned and misaligned regions.
+static uint32_t check(void) {
+    uint32_t errors = 0;
+    size_t sizes[] = {0, 7, 100, SNRT_MEMOPS_DMA_THRESHOLD + 13, 4000};
+    size_t offsets[] = {0, 3};
+    for (int i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        for (int j = 0; j < sizeof(offsets) / sizeof(offsets[0]); j++) {
+            errors += check_memcpy(offsets[j], sizes[i]);
+            errors += check_memset(offsets[j], sizes[i], 0);
+            errors += check_memset(offsets[j], sizes[i], 0x5C);
+        }
+    }
+    return errors;
+}
+
+// Report the cycles taken by both implementations for every size, and the
+// smallest size from which the DMA is faster.
+static void benchmark(const char *core) {
+    size_t memcpy_crossover = 0, memset_crossover = 0;
+    for (size_t n = MIN_SIZE; n <= MAX_SIZE; n *= 2) {
+        uint32_t t0 = snrt_mcycle();
+        snrt_memcpy_cpu(dst, src, n);
+        uint32_t t1 = snrt_mcycle();
+        snrt_memcpy_dma(dst, src, n);
+        uint32_t t2 = snrt_mcycle();
+        snrt_memset_cpu(dst, 0, n);
+        uint32_t t3 = snrt_mcycle();
+        snrt_memset_dma(dst, 0, n);
+        uint32_t t4 = snrt_mcycle();
+        printf("[memops] %s size=%u memcpy cpu=%u dma=%u", core, n, t1 - t0,
+               t2 - t1);
+        printf(" memset cpu=%u dma=%u\n", t3 - t2, t4 - t3);
+        if (!memcpy_crossover && (t2 - t1) < (t1 - t0)) memcpy_crossover = n;
+        if (!memset_crossover && (t4 - t3) < (t3 - t2)) memset_crossover = n;
+    }
+    printf("[memops] %s crossover memcpy=%u memset=%u\n", core,
+           memcpy_crossover, memset_crossover);
+}
+
+int main() {
+    uint32_t errors = 0;
+    if (snrt_cluster_idx() != 0) return 0;
+
+    // DM core, programming the DMA directly
+    if (snrt_is_dm_core()) {
+        src = snrt_l1_alloc(MAX_SIZE);
+        dst = snrt_l1_alloc(MAX_SIZE);
+        for (size_t i = 0; i < MAX_SIZE; i++) src[i] = i * 7 + 1;
+        errors += check();
+        benchmark("dm");
+    }
+    snrt_cluster_hw_barrier();
+
+    // Compute core, delegating to the data mover
+    dm_init();
+    if (snrt_is_dm_core()) {
+        dm_main();
+    } else if (snrt_cluster_core_idx() == 0) {
+        dm_wait_ready();
+        errors += check();
+        benchmark("compute");
+        dm_exit();
+    }
+
+    return errors;
+}
@@ -0,0 +1,88 @@
+// Copyright 2020 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "snrt.h"
+
+// Row i of the triangular loop costs i + 1 iterations, so a static block
+// partition leaves the threads with the first rows idle most of the time
+#define TRI_N 96
+
+static unsigned check(const char *name, double *y, uint32_t cycles) {
+    unsigned errs = 0;
+    for (unsigned i = 0; i < TRI_N; i++) {
+        double gold = (double)(i * (i + 1) / 2);
+        if (y[i] != gold) errs++;
+        y[i] = 0.0;
+    }
+    printf("%-8s %d cycles\n", name, cycles);
+    if (errs) printf("Error [%s]: %d mismatches\n", name, errs);
+    return errs ? 1 : 0;
+}
+
+uint32_t __attribute__((noinline)) static_triangular(double *x, double *y) {
+    uint32_t start = snrt_mcycle();
+#pragma omp parallel firstprivate(x, y)
+    {
+#pragma omp for schedule(static)
+        for (unsigned i = 0; i < TRI_N; i++) {
+            double acc = 0.0;
+            for (unsigned j = 0; j <= i; j++) acc += x[j];
+            y[i] = acc;
+        }
+    }
+    return snrt_mcycle() - start;
+}
+
+uint32_t __attribute__((noinline)) dynamic_triangular(double *x, double *y) {
+    uint32_t start = snrt_mcycle();
+#pragma omp parallel firstprivate(x, y)
+    {
+#pragma omp for schedule(dynamic, 2)
+        for (unsigned i = 0; i < TRI_N; i++) {
+            double acc = 0.0;
+            for (unsigned j = 0; j <= i; j++) acc += x[j];
+            y[i] = acc;
+        }
+    }
+    return snrt_mcycle() - start;
+}
+
+uint32_t __attribute__((noinline)) guided_triangular(double *x, double *y) {
+    uint32_t start = snrt_mcycle();
+#pragma omp parallel firstprivate(x, y)
+    {
+#pragma omp for schedule(guided)
+        for (unsigned i = 0; i < TRI_N; i++) {
+            double acc = 0.0;
+            for (unsigned j = 0; j <= i; j++) acc += x[j];
+            y[i] = acc;
+        }
+    }
+    return snrt_mcycle() - start;
+}
+
+int main() {
+    unsigned core_idx = snrt_cluster_core_idx();
+    unsigned err = 0;
+
+    // Only core 0 executes the statements below this function
+    __snrt_omp_bootstrap(core_idx);
+
+    double *x = snrt_l1_alloc(sizeof(double) * TRI_N);
+    double *y = snrt_l1_alloc(sizeof(double) * TRI_N);
+    for (unsigned i = 0; i < TRI_N; i++) x[i] = (double)i;
+
+    printf("Dynamic schedule test\n");
+    err |= check("static", y, static_triangular(x, y));
+    err |= check("dynamic", y, dynamic_triangular(x, y));
+    err |= check("guided", y, guided_triangular(x, y));
+
+    // Run twice to cover reuse of the work-stealing deques
+    err |= check("dynamic", y, dynamic_triangular(x, y));
+    OMP_PROF(omp_print_prof());
+
+    // exit
+    __snrt_omp_destroy(core_idx);
+    return err;
+}
@@ -0,0 +1,97 @@
+// Copyright 2020 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "snrt.h"
+
+#define RED_N 256
+
+static uint32_t atomic_sum;
+
+uint32_t __attribute__((noinline)) reduction_int(uint32_t *x, uint32_t *res) {
+    uint32_t sum = 0;
+    uint32_t start = snrt_mcycle();
+#pragma omp parallel for reduction(+ : sum) firstprivate(x)
+    for (unsigned i = 0; i < RED_N; i++) sum += x[i];
+    *res = sum;
+    return snrt_mcycle() - start;
+}
+
+uint32_t __attribute__((noinline)) atomic_int(uint32_t *x, uint32_t *res) {
+    atomic_sum = 0;
+    uint32_t start = snrt_mcycle();
+#pragma omp parallel firstprivate(x)
+    {
+        uint32_t sum = 0;
+#pragma omp for schedule(static)
+        for (unsigned i = 0; i < RED_N; i++) sum += x[i];
+        __atomic_add_fetch(&atomic_sum, sum, __ATOMIC_RELAXED);
+    }
+    *res = atomic_sum;
+    return snrt_mcycle() - start;
+}
+
+uint32_t __attribute__((noinline)) reduction_fp64(double *x, double *res_sum,
+                                                  double *res_max) {
+    double sum = 0.0, max = 0.0;
+    uint32_t start = snrt_mcycle();
+#pragma omp parallel firstprivate(x)
+    {
+#pragma omp for reduction(+ : sum)
+        for (unsigned i = 0; i < RED_N; i++) sum += x[i];
+#pragma omp for reduction(max : max) nowait
+        for (unsigned i = 0; i < RED_N; i++) max = x[i] > max ? x[i] : max;
+    }
+    *res_sum = sum;
+    *res_max = max;
+    return snrt_mcycle() - start;
+}
+
+int main() {
+    unsigned core_idx = snrt_cluster_core_idx();
+    unsigned err = 0;
+    uint32_t cycles, res, gold = 0;
+    double res_sum, res_max, gold_sum = 0.0, gold_max = 0.0;
+
+    // Only core 0 executes the statements below this function
+    __snrt_omp_bootstrap(core_idx);
+
+    uint32_t *xi = snrt_l1_alloc(sizeof(uint32_t) * RED_N);
+    double *xd = snrt_l1_alloc(sizeof(double) * RED_N);
+    for (unsigned i = 0; i < RED_N; i++) {
+        xi[i] = i * 3 + 1;
+        xd[i] = (double)((i * 7) % 61);
+        gold += xi[i];
+        gold_sum += xd[i];
+        gold_max = xd[i] > gold_max ? xd[i] : gold_max;
+    }
+
+    printf("Reduction test\n");
+    cycles = reduction_int(xi, &res);
+    printf("%-10s %d cycles\n", "reduction", cycles);
+    if (res != gold) {
+        printf("Error [reduction_int]: %d != %d\n", res, gold);
+        err |= 1 << 0;
+    }
+
+    cycles = atomic_int(xi, &res);
+    printf("%-10s %d cycles\n", "atomic", cycles);
+    if (res != gold) {
+        printf("Error [atomic_int]: %d != %d\n", res, gold);
+        err |= 1 << 1;
+    }
+
+    // Run twice to cover reuse of the reduction state
+    for (unsigned rep = 0; rep < 2; rep++) {
+        cycles = reduction_fp64(xd, &res_sum, &res_max);
+        printf("%-10s %d cycles\n", "fp64", cycles);
+        if (res_sum != gold_sum || res_max != gold_max) {
+            printf("Error [reduction_fp64]: mismatch\n");
+            err |= 1 << 2;
+        }
+    }
+
+    // exit
+    __snrt_omp_destroy(core_idx);
+    return err;
+}
@@ -0,0 +1,81 @@
+// Copyright 2020 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "snrt.h"
+
+#define FIB_N 12
+#define FIB_GOLD 144
+#define N_TASKS 64
+
+static uint32_t fib(uint32_t n) {
+    uint32_t a, b;
+    if (n < 2) return n;
+#pragma omp task shared(a) firstprivate(n)
+    a = fib(n - 1);
+#pragma omp task shared(b) firstprivate(n)
+    b = fib(n - 2);
+#pragma omp taskwait
+    return a + b;
+}
+
+unsigned __attribute__((noinline)) recursive_tasks(void) {
+    uint32_t res = 0;
+#pragma omp parallel shared(res)
+    {
+#pragma omp single
+        res = fib(FIB_N);
+    }
+    if (res != FIB_GOLD) {
+        printf("Error [recursive_tasks]: fib(%d) = %d\n", FIB_N, res);
+        return 1;
+    }
+    return 0;
+}
+
+unsigned __attribute__((noinline)) irregular_tasks(uint32_t *out) {
+    uint32_t executed_by[16] = {0};
+#pragma omp parallel firstprivate(out) shared(executed_by)
+    {
+        // One producer, the tasks are picked up by the other threads in the
+        // implicit barrier at the end of the single construct
+#pragma omp single
+        for (uint32_t i = 0; i < N_TASKS; i++) {
+#pragma omp task firstprivate(i, out)
+            {
+                // Work grows with the task index
+                uint32_t acc = 0;
+                for (uint32_t j = 0; j <= i; j++) acc += j;
+                out[i] = acc;
+                __atomic_add_fetch(&executed_by[omp_get_thread_num()], 1,
+                                   __ATOMIC_RELAXED);
+            }
+        }
+    }
+
+    unsigned errs = 0;
+    for (uint32_t i = 0; i < N_TASKS; i++)
+        if (out[i] != i * (i + 1) / 2) errs++;
+    for (uint32_t i = 0; i < omp_get_num_threads(); i++)
+        printf("core %d ran %d tasks\n", i, executed_by[i]);
+    if (errs) printf("Error [irregular_tasks]: %d mismatches\n", errs);
+    return errs ? 1 : 0;
+}
+
+int main() {
+    unsigned core_idx = snrt_cluster_core_idx();
+    unsigned err = 0;
+
+    // Only core 0 executes the statements below this function
+    __snrt_omp_bootstrap(core_idx);
+
+    uint32_t *out = snrt_l1_alloc(sizeof(uint32_t) * N_TASKS);
+
+    printf("Tasking test\n");
+    err |= recursive_tasks();
+    err |= irregular_tasks(out) << 1;
+
+    // exit
+    __snrt_omp_destroy(core_idx);
+    return err;
+}
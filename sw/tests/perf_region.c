@@ -0,0 +1,64 @@
+// Copyright 2023 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "snrt.h"
+
+#define N_ITERS 4
+#define N_NOPS 100
+
+static inline void busy_wait() {
+    for (int i = 0; i < N_NOPS; i++) {
+        asm volatile("nop");
+    }
+}
+
+int main() {
+    uint32_t errors = 0;
+
+    if (snrt_cluster_core_idx() != 0) return 0;
+
+    // Test 1: Check that regions can be nested and are accumulated
+    // over multiple instances
+    for (int i = 0; i < N_ITERS; i++) {
+        snrt_perf_region_begin(0);
+        busy_wait();
+        snrt_perf_region_begin(1);
+        busy_wait();
+        snrt_perf_region_end(1);
+        snrt_perf_region_end(0);
+    }
+
+    snrt_perf_profile_t *perf = &(cls()->perf);
+    snrt_perf_region_t *outer = &(perf->regions[0]);
+    snrt_perf_region_t *inner = &(perf->regions[1]);
+
+    // The default metric set tracks cycles and retired instructions
+    errors += (perf->num_metrics == 0);
+    errors += (outer->count != N_ITERS);
+    errors += (inner->count != N_ITERS);
+    errors += (outer->total[0] < 2 * N_ITERS * N_NOPS);
+    errors += (inner->total[0] < N_ITERS * N_NOPS);
+    errors += (inner->total[0] >= outer->total[0]);
+    errors += (outer->total[4] < 2 * N_ITERS * N_NOPS);
+
+    // Test 2: Check that out-of-range regions are ignored
+    snrt_perf_region_begin(SNRT_PERF_MAX_REGIONS);
+    snrt_perf_region_end(SNRT_PERF_MAX_REGIONS);
+    for (int i = 2; i < SNRT_PERF_MAX_REGIONS; i++) {
+        errors += (perf->regions[i].count != 0);
+    }
+
+    // Test 3: Check that a custom metric set can be configured
+    const uint32_t metrics[] = {
+        SNRT_PERF_METRIC(SNRT_PERF_METRIC_ID(RETIRED_INSTR), 0)};
+    snrt_perf_region_config(metrics, 1);
+    snrt_perf_region_begin(2);
+    busy_wait();
+    snrt_perf_region_end(2);
+    errors += (perf->num_metrics != 1);
+    errors += (perf->regions[2].total[0] < N_NOPS);
+
+    // The region totals are dumped at exit
+    return errors;
+}
@@ -0,0 +1,129 @@
+// Copyright 2023 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+// Compares the cost of programming the SSRs on every tile of a small-tile
+// GEMM (C[t] = A[t] * B[t], with 1xK A tiles and KxN B tiles) using the
+// `snrt_ssr_loop_*d()` functions and using precomputed stream descriptors.
+
+#include "snrt.h"
+
+#define N_TILES 16
+#define K 8
+#define N 8
+
+// Shapes are hidden from the compiler, as in tiled kernels
+static volatile uint32_t k_dim = K;
+static volatile uint32_t n_dim = N;
+
+static inline void tile_kernel(double *c) {
+    double c0 = 0, c1 = 0, c2 = 0, c3 = 0, c4 = 0, c5 = 0, c6 = 0, c7 = 0;
+    asm volatile(
+        "frep.o %[n_frep], 8, 0, 0 \n"
+        "fmadd.d %[c0], ft0, ft1, %[c0] \n"
+        "fmadd.d %[c1], ft0, ft1, %[c1] \n"
+        "fmadd.d %[c2], ft0, ft1, %[c2] \n"
+        "fmadd.d %[c3], ft0, ft1, %[c3] \n"
+        "fmadd.d %[c4], ft0, ft1, %[c4] \n"
+        "fmadd.d %[c5], ft0, ft1, %[c5] \n"
+        "fmadd.d %[c6], ft0, ft1, %[c6] \n"
+        "fmadd.d %[c7], ft0, ft1, %[c7] \n"
+        : [ c0 ] "+f"(c0), [ c1 ] "+f"(c1), [ c2 ] "+f"(c2), [ c3 ] "+f"(c3),
+          [ c4 ] "+f"(c4), [ c5 ] "+f"(c5), [ c6 ] "+f"(c6), [ c7 ] "+f"(c7)
+        : [ n_frep ] "r"(K - 1)
+        : "ft0", "ft1", "ft2");
+    c[0] = c0;
+    c[1] = c1;
+    c[2] = c2;
+    c[3] = c3;
+    c[4] = c4;
+    c[5] = c5;
+    c[6] = c6;
+    c[7] = c7;
+    snrt_fpu_fence();
+}
+
+// Reprogram the full stream shapes on every tile
+static uint32_t gemm_loop(double *a, double *b, double *c) {
+    uint32_t k = k_dim, n = n_dim;
+    uint32_t start = snrt_mcycle();
+    for (uint32_t t = 0; t < N_TILES; t++) {
+        snrt_ssr_loop_1d(SNRT_SSR_DM0, k, sizeof(double));
+        snrt_ssr_repeat(SNRT_SSR_DM0, n);
+        snrt_ssr_loop_2d(SNRT_SSR_DM1, n, k, sizeof(double),
+                         n * sizeof(double));
+        snrt_ssr_read(SNRT_SSR_DM0, SNRT_SSR_1D, a + t * k);
+        snrt_ssr_read(SNRT_SSR_DM1, SNRT_SSR_2D, b + t * k * n);
+        snrt_ssr_enable();
+        tile_kernel(c + t * n);
+        snrt_ssr_disable();
+    }
+    return snrt_mcycle() - start;
+}
+
+// Build the stream descriptors once, and reapply them on every tile
+// (`reapply`) or only reprogram the pointers
+static uint32_t gemm_desc(double *a, double *b, double *c, int reapply) {
+    uint32_t k = k_dim, n = n_dim;
+    uint32_t start = snrt_mcycle();
+    snrt_ssr_desc_t a_desc = SNRT_SSR_DESC_1D(k, sizeof(double));
+    snrt_ssr_desc_repeat(&a_desc, n);
+    const snrt_ssr_desc_t b_desc =
+        SNRT_SSR_DESC_2D(n, k, sizeof(double), n * sizeof(double));
+    snrt_ssr_desc_apply(SNRT_SSR_DM0, &a_desc);
+    snrt_ssr_desc_apply(SNRT_SSR_DM1, &b_desc);
+    for (uint32_t t = 0; t < N_TILES; t++) {
+        if (reapply) {
+            snrt_ssr_desc_apply(SNRT_SSR_DM0, &a_desc);
+            snrt_ssr_desc_apply(SNRT_SSR_DM1, &b_desc);
+        }
+        snrt_ssr_desc_read(SNRT_SSR_DM0, &a_desc, a + t * k);
+        snrt_ssr_desc_read(SNRT_SSR_DM1, &b_desc, b + t * k * n);
+        snrt_ssr_enable();
+        tile_kernel(c + t * n);
+        snrt_ssr_disable();
+    }
+    return snrt_mcycle() - start;
+}
+
+static uint32_t check(double *a, double *b, double *c) {
+    uint32_t errors = 0;
+    for (uint32_t t = 0; t < N_TILES; t++) {
+        for (uint32_t j = 0; j < N; j++) {
+            double ref = 0;
+            for (uint32_t i = 0; i < K; i++)
+                ref += a[t * K + i] * b[(t * K + i) * N + j];
+            errors += (c[t * N + j] != ref);
+            c[t * N + j] = 0;
+        }
+    }
+    return errors != 0;
+}
+
+int main() {
+    uint32_t errors = 0;
+
+    if (snrt_cluster_idx() != 0 || snrt_cluster_core_idx() != 0) return 0;
+
+    double *a = snrt_l1_next();
+    double *b = a + N_TILES * K;
+    double *c = b + N_TILES * K * N;
+    for (uint32_t i = 0; i < N_TILES * K; i++) a[i] = (double)(i % 7);
+    for (uint32_t i = 0; i < N_TILES * K * N; i++) b[i] = (double)(i % 5);
+    for (uint32_t i = 0; i < N_TILES * N; i++) c[i] = 0;
+
+    // Test 1: Descriptors match the shapes programmed by the loop functions
+    uint32_t cycles_loop = gemm_loop(a, b, c);
+    errors += check(a, b, c);
+    uint32_t cycles_desc = gemm_desc(a, b, c, 1);
+    errors += check(a, b, c) << 1;
+
+    // Test 2: Shapes persist across tiles when only pointers are rewritten
+    uint32_t cycles_ptr = gemm_desc(a, b, c, 0);
+    errors += check(a, b, c) << 2;
+
+    printf("SSR setup over %d tiles: loop %d, desc %d, ptr-only %d cycles\n",
+           N_TILES, cycles_loop, cycles_desc, cycles_ptr);
+
+    return errors;
+}
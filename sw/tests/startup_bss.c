@@ -0,0 +1,56 @@
+// Copyright 2023 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+// Checks that the .bss is cleared before `main` and reports the startup
+// latency, together with the cost of the distributed .bss clearing for
+// growing sizes.
+
+#include "snrt.h"
+
+#define MIN_SIZE 0x400
+#define MAX_SIZE 0x10000
+
+static uint32_t buffer[MAX_SIZE / sizeof(uint32_t)];
+
+static inline void wait_all_channels() {
+    snrt_dma_wait_all();
+    for (uint32_t c = 1; c < SNRT_CLUSTER_DMA_NUM_CHANNELS; c++)
+        snrt_dma_wait_all_channel(c);
+}
+
+int main() {
+    // The cycle counter starts at reset
+    uint32_t reset_to_main = snrt_mcycle();
+    uint32_t errors = 0;
+
+    if (!snrt_is_dm_core()) return 0;
+
+    // Test 1: Check that the .bss was cleared. Every cluster checks a
+    // different slice of the buffer.
+    uint32_t len = MAX_SIZE / sizeof(uint32_t) / snrt_cluster_num();
+    uint32_t *slice = buffer + snrt_cluster_idx() * len;
+    for (uint32_t i = 0; i < len; i++) errors += (slice[i] != 0);
+
+    // Test 2: Time the distributed clearing of growing regions
+    for (uint32_t size = MIN_SIZE; size <= MAX_SIZE; size *= 2) {
+        snrt_inter_cluster_barrier();
+        uint32_t start = snrt_mcycle();
+        snrt_dma_start_zero_global((size_t)buffer, size);
+        wait_all_channels();
+        snrt_inter_cluster_barrier();
+        uint32_t cycles = snrt_mcycle() - start;
+        if (snrt_cluster_idx() == 0)
+            printf("Cleared %d B with %d clusters in %d cycles\n", size,
+                   snrt_cluster_num(), cycles);
+    }
+
+    if (snrt_cluster_idx() == 0) {
+        extern volatile uint32_t __bss_start, __bss_end;
+        size_t bss_size = (size_t)(&__bss_end) - (size_t)(&__bss_start);
+        printf("Reset to main with %d B of .bss: %d cycles\n", bss_size,
+               reset_to_main);
+    }
+
+    return errors;
+}
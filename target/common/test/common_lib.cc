@@ -2,6 +2,8 @@
 // Solderpad Hardware License, Version 0.51, see LICENSE for details.
 // SPDX-License-Identifier: SHL-0.51
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 
 #include "sim.hh"
@@ -56,4 +58,65 @@ void Sim::write_chunk(addr_t taddr, size_t len, const void *src) {
     MEM.write(taddr, len, reinterpret_cast<const uint8_t *>(src), strb);
 }
 
+// Size of the console header and of the header of each ring, see `putchar.c`.
+static const size_t CONSOLE_HEADER_SIZE = 64;
+
+std::map<std::string, uint64_t> Sim::load_payload(const std::string &payload,
+                                                  reg_t *entry) {
+    auto symbols = htif_t::load_payload(payload, entry);
+    auto it = symbols.find("snrt_console");
+    if (it != symbols.end()) console_addr = it->second;
+    return symbols;
+}
+
+// Consume all records published by the harts. Lines may span multiple
+// records, so output is kept per hart and only printed line by line.
+void Sim::drain_console(bool exited) {
+    if (!console_addr) return;
+
+    uint32_t hdr[3];
+    MEM.read(console_addr, sizeof(hdr), reinterpret_cast<uint8_t *>(hdr));
+    uint32_t num_rings = hdr[0], ring_size = hdr[1], record_size = hdr[2];
+    size_t ring_stride = CONSOLE_HEADER_SIZE + ring_size * record_size;
+    console_lines.resize(num_rings);
+
+    std::vector<uint8_t> record(record_size);
+    for (uint32_t i = 0; i < num_rings; i++) {
+        addr_t ring = console_addr + CONSOLE_HEADER_SIZE + i * ring_stride;
+        uint32_t idx[2];
+        MEM.read(ring, sizeof(idx), reinterpret_cast<uint8_t *>(idx));
+        uint32_t head = idx[0], tail = idx[1];
+        if (head == tail) continue;
+
+        std::string &line = console_lines[i];
+        for (; tail != head; tail++) {
+            addr_t addr = ring + CONSOLE_HEADER_SIZE +
+                          (tail % ring_size) * record_size;
+            MEM.read(addr, record_size, record.data());
+            uint32_t len;
+            std::memcpy(&len, record.data(), sizeof(len));
+            len = std::min<uint32_t>(len, record_size - sizeof(len));
+            for (uint32_t j = 0; j < len; j++) {
+                char c = record[sizeof(len) + j];
+                line += c;
+                if (c == '\n') {
+                    std::cout << line;
+                    line.clear();
+                }
+            }
+        }
+        MEM.write(ring + sizeof(head), sizeof(tail),
+                  reinterpret_cast<const uint8_t *>(&tail), nullptr);
+    }
+
+    // Print incomplete lines too once the binary has exited
+    if (exited) {
+        for (auto &line : console_lines) {
+            std::cout << line;
+            line.clear();
+        }
+    }
+    std::cout << std::flush;
+}
+
 }  // namespace sim
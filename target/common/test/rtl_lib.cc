@@ -37,7 +37,10 @@ Sim::Sim(int argc, char **argv) : htif_t(argc, argv), ipc(argc, argv) {
     target.switch_to();
 }
 
-void Sim::idle() { host->switch_to(); }
+void Sim::idle() {
+    if (++console_polls % CONSOLE_POLL_INTERVAL == 0) drain_console();
+    host->switch_to();
+}
 
 // A single tick.
 int Sim::run() {
@@ -49,6 +52,7 @@ int Sim::run() {
 // Host thread.
 void Sim::main() {
     htif_t::run();
+    drain_console(true);
     // HTIF has finished, just idle now.
     while (true) {
         idle();
@@ -9,8 +9,10 @@
 #include <chrono>
 #include <iomanip>
 #include <iostream>
+#include <map>
 #include <memory>
 #include <set>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
@@ -19,6 +21,9 @@
 namespace sim {
 using namespace std::chrono_literals;
 
+// Number of idle calls between two polls of the console ring buffers.
+const unsigned CONSOLE_POLL_INTERVAL = 64;
+
 // Simulation object with `fesvr` support.
 struct Sim : htif_t {
     Sim(int argc, char **argv);
@@ -37,6 +42,10 @@ struct Sim : htif_t {
 
     void idle();
 
+    // Print the output the harts queued in the console ring buffers. Once
+    // the binary has `exited`, incomplete lines are printed as well.
+    void drain_console(bool exited = false);
+
     // Force alignment to 8 byte.
     size_t chunk_align() { return 8; }
     // Force chunk size to 8 byte.
@@ -44,12 +53,20 @@ struct Sim : htif_t {
 
     void reset() {}
 
+   protected:
+    // Capture the address of the console ring buffers while loading.
+    std::map<std::string, uint64_t> load_payload(const std::string &payload,
+                                                 reg_t *entry) override;
+
    private:
     context_t *host;
     context_t target;
     bool vlt_vcd = false;
     bool disable_preloading = false;
     IpcIface ipc;
+    addr_t console_addr = 0;
+    unsigned console_polls = 0;
+    std::vector<std::string> console_lines;
 };
 
 void sim_thread_main(void *arg);
@@ -35,13 +35,18 @@ Sim::Sim(int argc, char **argv) : htif_t(argc, argv), ipc(argc, argv) {
     Verilated::commandArgs(argc, argv);
 }
 
-void Sim::idle() { target.switch_to(); }
+void Sim::idle() {
+    if (++console_polls % CONSOLE_POLL_INTERVAL == 0) drain_console();
+    target.switch_to();
+}
 
 /// Execute the simulation.
 int Sim::run() {
     host = context_t::current();
     target.init(sim_thread_main, this);
-    return htif_t::run();
+    int exitcode = htif_t::run();
+    drain_console(true);
+    return exitcode;
 }
 
 void Sim::main() {
@@ -50,9 +50,16 @@ include sw/tests/tests.mk
 APPS  = sw/apps/nop
 APPS += sw/apps/blas/axpy
 APPS += sw/apps/blas/gemm
+APPS += sw/apps/blas/gemm_ukernel
+APPS += sw/apps/blas/gemm_batched
+APPS += sw/apps/blas/gemm_epilogue
 APPS += sw/apps/blas/gemv
+APPS += sw/apps/blas/gemv_trans
 APPS += sw/apps/blas/dot
 APPS += sw/apps/blas/syrk
+APPS += sw/apps/blas/sparse
+APPS += sw/apps/blas/trsm
+APPS += sw/apps/blas/potrf
 APPS += sw/apps/dnn/batchnorm
 APPS += sw/apps/dnn/conv2d
 APPS += sw/apps/dnn/fusedconv
@@ -0,0 +1,20 @@
+#!/bin/sh
+# Copyright 2024 ETH Zurich and University of Bologna.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+#
+# Validate the GEMM planner's performance model on the shape sweep in
+# sw/blas/gemm/data/sweep.json, and calibrate its constants.
+
+ROOT=$(git rev-parse --show-toplevel)
+BUILD_PY=$ROOT/target/snitch_cluster/util/build.py
+RUN_PY=$ROOT/target/snitch_cluster/util/run.py
+PLANNER_PY=$ROOT/sw/blas/gemm/scripts/planner.py
+TEST_LIST=$(pwd)/run.yaml
+CFG_DIR=$(pwd)/cfg
+CMD="$ROOT/sw/blas/gemm/scripts/verify.py \${sim_bin} \${elf}"
+
+$PLANNER_PY sweep $ROOT/sw/blas/gemm/data/sweep.json --cfg-dir $CFG_DIR
+$BUILD_PY gemm --cfg $CFG_DIR/* --testlist $TEST_LIST --testlist-cmd "$CMD"
+$RUN_PY $TEST_LIST --simulator vsim -j --run-dir runs
+$PLANNER_PY validate --fit runs/*/sim.txt
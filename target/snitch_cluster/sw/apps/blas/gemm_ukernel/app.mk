@@ -0,0 +1,13 @@
+# Copyright 2024 ETH Zurich and University of Bologna.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+APP                  := gemm_ukernel
+$(APP)_BUILD_DIR     ?= $(ROOT)/target/snitch_cluster/sw/apps/blas/$(APP)/build
+SRC_DIR              := $(ROOT)/sw/blas/gemm/src
+SRCS                 := $(SRC_DIR)/ukernel.c
+$(APP)_INCDIRS       := $(ROOT)/sw/blas
+$(APP)_DATA_CFG      := $(ROOT)/sw/blas/gemm/data/ukernel.json
+
+include $(ROOT)/sw/apps/common.mk
+include $(ROOT)/target/snitch_cluster/sw/apps/common.mk
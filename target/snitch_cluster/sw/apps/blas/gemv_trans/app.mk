@@ -0,0 +1,12 @@
+# Copyright 2024 ETH Zurich and University of Bologna.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+APP                  := gemv_trans
+$(APP)_BUILD_DIR     ?= $(ROOT)/target/snitch_cluster/sw/apps/blas/$(APP)/build
+SRC_DIR              := $(ROOT)/sw/blas/gemv/src
+SRCS                 := $(SRC_DIR)/main.c
+$(APP)_DATA_CFG      := $(ROOT)/sw/blas/gemv/data/params_trans.json
+
+include $(ROOT)/sw/apps/common.mk
+include $(ROOT)/target/snitch_cluster/sw/apps/common.mk
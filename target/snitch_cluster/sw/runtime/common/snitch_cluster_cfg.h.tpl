@@ -8,6 +8,7 @@
 #define SNRT_CLUSTER_CORE_NUM CFG_CLUSTER_NR_CORES
 #define SNRT_CLUSTER_NUM ${cfg['nr_clusters']}
 #define SNRT_CLUSTER_DM_CORE_NUM 1
+#define SNRT_CLUSTER_DMA_NUM_CHANNELS ${cfg['cluster']['dma_nr_channels']}
 #define SNRT_TCDM_START_ADDR CLUSTER_TCDM_BASE_ADDR
 #define SNRT_TCDM_SIZE (CLUSTER_PERIPH_BASE_ADDR - CLUSTER_TCDM_BASE_ADDR)
 #define SNRT_CLUSTER_OFFSET ${cfg['cluster']['cluster_base_offset']}
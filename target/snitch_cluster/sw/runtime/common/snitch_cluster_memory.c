@@ -11,3 +11,5 @@ extern volatile uint32_t* snrt_cluster_clint_set_ptr();
 extern volatile uint32_t* snrt_cluster_clint_clr_ptr();
 
 extern volatile uint32_t* snrt_zero_memory_ptr();
+
+extern size_t snrt_zero_memory_size();
@@ -54,3 +54,7 @@ inline uint32_t snrt_cluster_perf_counters_addr() {
 inline volatile uint32_t* snrt_zero_memory_ptr() {
     return (uint32_t*)(CLUSTER_ZERO_MEM_START_ADDR + cluster_base_offset());
 }
+
+inline size_t snrt_zero_memory_size() {
+    return CLUSTER_ZERO_MEM_END_ADDR - CLUSTER_ZERO_MEM_START_ADDR;
+}
@@ -21,45 +21,83 @@ void _putchar(char character) {
     }
 }
 
+// Every line is written out as soon as it is complete.
+void snrt_putchar_flush() {}
+
 #else
-extern uintptr_t volatile tohost, fromhost;
 
-// Rudimentary string buffer for putc calls.
-#define PUTC_BUFFER_LEN (1024 - sizeof(size_t))
+// Console ring buffers drained by the host.
+//
+// Each hart accumulates characters in a small staging record in its TLS
+// (i.e. in TCDM). Complete lines, or full records, are published to a
+// per-hart ring in L3 by bumping its head index. The host polls the rings
+// (through the `snrt_console` symbol) while it is idle and advances the tail
+// index as it consumes records. A hart therefore only ever waits on the host
+// when its ring is full, rather than on every line.
+#define SNRT_CONSOLE_RECORD_SIZE 64
+#define SNRT_CONSOLE_RING_SIZE 16
+#define SNRT_CONSOLE_NUM_RINGS (SNRT_CLUSTER_NUM * SNRT_CLUSTER_CORE_NUM)
+
+typedef struct {
+    uint32_t len;
+    char data[SNRT_CONSOLE_RECORD_SIZE - sizeof(uint32_t)];
+} snrt_console_record_t;
+
+typedef struct {
+    volatile uint32_t head;  // Records published by the hart
+    volatile uint32_t tail;  // Records consumed by the host
+    uint32_t reserved[14];
+    snrt_console_record_t records[SNRT_CONSOLE_RING_SIZE];
+} snrt_console_ring_t;
 
+// The host relies on this layout: a 64-byte header followed by the rings.
 typedef struct {
-    size_t size;
-    uint64_t syscall_mem[8];
-} putc_buffer_header_t;
+    uint32_t num_rings;
+    uint32_t ring_size;
+    uint32_t record_size;
+    uint32_t reserved[13];
+    snrt_console_ring_t rings[SNRT_CONSOLE_NUM_RINGS];
+} snrt_console_t;
+
+snrt_console_t snrt_console __attribute__((section(".dram")))
+__attribute__((aligned(64))) = {
+    .num_rings = SNRT_CONSOLE_NUM_RINGS,
+    .ring_size = SNRT_CONSOLE_RING_SIZE,
+    .record_size = SNRT_CONSOLE_RECORD_SIZE,
+};
 
-typedef struct putc_buffer {
-    putc_buffer_header_t hdr;
-    char data[PUTC_BUFFER_LEN];
-} putc_buffer_t;
+static __thread snrt_console_record_t console_record;
 
-static volatile putc_buffer_t
-    putc_buffer[SNRT_CLUSTER_NUM * SNRT_CLUSTER_CORE_NUM]
-    __attribute__((section(".dram")));
+// Publish the pending characters of the current hart, if any.
+void snrt_putchar_flush() {
+    snrt_console_record_t *record = &console_record;
+    if (record->len == 0) return;
+
+    // Wait only if the host has fallen a full ring behind
+    snrt_console_ring_t *ring = &snrt_console.rings[snrt_hartid()];
+    uint32_t head = ring->head;
+    while (head - ring->tail >= SNRT_CONSOLE_RING_SIZE)
+        ;
+
+    // Copy the used part of the record with word stores
+    volatile uint32_t *dst =
+        (volatile uint32_t *)&ring->records[head % SNRT_CONSOLE_RING_SIZE];
+    uint32_t *src = (uint32_t *)record;
+    uint32_t num_words = 1 + (record->len + 3) / 4;
+    for (uint32_t i = 0; i < num_words; i++) dst[i] = src[i];
+
+    // Make the record visible before publishing it
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    ring->head = head + 1;
+    record->len = 0;
+}
 
 // Provide an implementation for putchar.
 void _putchar(char character) {
-    volatile struct putc_buffer *buf = &putc_buffer[snrt_hartid()];
-    buf->data[buf->hdr.size++] = character;
-    if (buf->hdr.size == PUTC_BUFFER_LEN || character == '\n') {
-        buf->hdr.syscall_mem[0] = 64;  // sys_write
-        buf->hdr.syscall_mem[1] = 1;   // file descriptor (1 = stdout)
-        buf->hdr.syscall_mem[2] = (uintptr_t)&buf->data;  // buffer
-        buf->hdr.syscall_mem[3] = buf->hdr.size;          // length
-
-        snrt_mutex_acquire(snrt_mutex());
-        tohost = (uintptr_t)buf->hdr.syscall_mem;
-        while (fromhost == 0)
-            ;
-        fromhost = 0;
-        snrt_mutex_release(snrt_mutex());
-
-        buf->hdr.size = 0;
-    }
+    snrt_console_record_t *record = &console_record;
+    record->data[record->len++] = character;
+    if (record->len == sizeof(record->data) || character == '\n')
+        snrt_putchar_flush();
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -11,6 +11,7 @@
 #define SNRT_CRT0_PRE_BARRIER
 #define SNRT_INVOKE_MAIN
 #define SNRT_CRT0_POST_BARRIER
+#define SNRT_CRT0_CALLBACK7
 #define SNRT_CRT0_EXIT
 
 extern volatile uint32_t tohost;
@@ -21,4 +22,11 @@ static inline volatile uint32_t* snrt_exit_code_destination() {
 }
 #endif
 
+// Emit the region profiler totals, if any, once all cores are done, and
+// publish any unterminated console output before the exit code is reported
+static inline void snrt_crt0_callback7() {
+    if (snrt_is_dm_core()) snrt_perf_region_dump();
+    snrt_putchar_flush();
+}
+
 #include "start.h"
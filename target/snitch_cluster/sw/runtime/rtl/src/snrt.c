@@ -12,7 +12,9 @@
 #include "dma.c"
 #include "eu.c"
 #include "kmp.c"
+#include "memops.c"
 #include "omp.c"
+#include "perf_cnt.c"
 #include "printf.c"
 #include "putchar.c"
 #include "riscv.c"
@@ -10,10 +10,13 @@
 // Forward declarations
 #include "alloc_decls.h"
 #include "cls_decls.h"
+#include "memops_decls.h"
+#include "perf_cnt_decls.h"
 #include "riscv_decls.h"
 #include "start_decls.h"
 #include "sync_decls.h"
 #include "team_decls.h"
+#include "types.h"
 
 // Snitch cluster specific
 #include "snitch_cluster_defs.h"
@@ -29,6 +32,7 @@
 #include "dump.h"
 #include "eu.h"
 #include "kmp.h"
+#include "memops.h"
 #include "omp.h"
 #include "perf_cnt.h"
 #include "printf.h"
@@ -38,4 +42,3 @@
 #include "ssr.h"
 #include "sync.h"
 #include "team.h"
-#include "types.h"
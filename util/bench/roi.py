@@ -19,14 +19,39 @@ Check out `test_data/data.json` and `test_data/spec.json` for an
 example input and specification file which can be fed as input to the
 tool respectively. The corresponding output is contained in
 `test_data/roi.json`.
+
+Alternatively, with the `--perf-log` option, the script parses the
+region profiler records which the snRuntime prints at exit (see
+`snrt_perf_region_dump()`) from a simulation log, and generates a JSON
+with the per-cluster region totals, without requiring an instruction
+trace.
 """
 
 import argparse
 import json
 import json5
 from mako.template import Template
+import re
 import sys
 
+# Magic word and format version of the region profiler record,
+# keep in sync with `sw/snRuntime/src/perf_cnt.h`
+PERF_RECORD_MAGIC = 0x66726570
+PERF_RECORD_VERSION = 1
+PERF_RECORD_REGEX = re.compile(r'\[perf\] ([0-9a-fA-F]+)')
+
+# Performance counter metrics, in the order they are enumerated in
+# `snitch_cluster_peripheral_reg.hjson`
+PERF_METRICS = [
+    'cycle', 'tcdm_accessed', 'tcdm_congested', 'issue_fpu', 'issue_fpu_seq',
+    'issue_core_to_fpu', 'retired_instr', 'retired_load', 'retired_i',
+    'retired_acc', 'dma_aw_stall', 'dma_ar_stall', 'dma_r_stall',
+    'dma_w_stall', 'dma_buf_w_stall', 'dma_buf_r_stall', 'dma_aw_done',
+    'dma_aw_bw', 'dma_ar_done', 'dma_ar_bw', 'dma_r_done', 'dma_r_bw',
+    'dma_w_done', 'dma_w_bw', 'dma_b_done', 'dma_busy', 'icache_miss',
+    'icache_hit', 'icache_prefetch', 'icache_double_hit', 'icache_stall'
+]
+
 
 def format_roi(roi, label):
     return {
@@ -84,15 +109,69 @@ def load_json_inputs(input_path, spec_path, **kwargs):
     return data, spec
 
 
+def parse_perf_record(record):
+    """Decode a hex-encoded region profiler record.
+
+    Returns the index of the cluster which emitted the record, and a
+    list of regions, each with its label, the number of times it was
+    entered and the accumulated metric totals.
+    """
+    words = [int(record[i:i+8], 16) for i in range(0, len(record), 8)]
+    if len(words) < 3 or words[0] != PERF_RECORD_MAGIC:
+        raise ValueError("Invalid region profiler record")
+    version, cluster_idx = words[1] >> 16, words[1] & 0xffff
+    if version != PERF_RECORD_VERSION:
+        raise ValueError(f"Unsupported region profiler record version {version}")
+    num_metrics, num_regions = words[2] >> 16, words[2] & 0xffff
+    if len(words) != 3 + num_metrics + num_regions * (2 + num_metrics):
+        raise ValueError("Truncated region profiler record")
+    # Name metrics, disambiguating metrics tracked on multiple harts
+    names = []
+    for sel in words[3:3 + num_metrics]:
+        metric, hart = sel >> 16, sel & 0xffff
+        name = PERF_METRICS[metric] if metric < len(PERF_METRICS) else f'metric_{metric}'
+        names.append(name if name not in names else f'{name}_hart{hart}')
+    # Decode regions
+    regions = []
+    idx = 3 + num_metrics
+    for _ in range(num_regions):
+        region_id, count = words[idx], words[idx + 1]
+        totals = words[idx + 2:idx + 2 + num_metrics]
+        regions.append({
+            "label": f"region_{region_id}",
+            "count": count,
+            "attrs": dict(zip(names, totals))
+        })
+        idx += 2 + num_metrics
+    return cluster_idx, regions
+
+
+def parse_perf_log(log_path):
+    output = {}
+    with open(log_path, 'r') as f:
+        for line in f:
+            match = PERF_RECORD_REGEX.search(line)
+            if match:
+                cluster_idx, regions = parse_perf_record(match.group(1))
+                output[f'cluster_{cluster_idx}'] = regions
+    return output
+
+
 def main():
     # Argument parsing
     parser = argparse.ArgumentParser()
     parser.add_argument(
         'input',
+        nargs='?',
         help='Input JSON file')
     parser.add_argument(
         'spec',
+        nargs='?',
         help='ROI specification file (JSON format)')
+    parser.add_argument(
+        '--perf-log',
+        help='Simulation log containing region profiler records, replaces the input and'
+             ' specification files')
     parser.add_argument(
         '--cfg',
         help='Hardware configuration file used to render the specification file')
@@ -104,15 +183,22 @@ def main():
         help='Output JSON file')
     args = parser.parse_args()
 
-    # Load hardware configuration
-    with open(args.cfg, 'r') as f:
-        cfg = json5.load(f)
+    if args.perf_log:
+        # Decode region profiler records
+        output = parse_perf_log(args.perf_log)
+    else:
+        if args.input is None or args.spec is None:
+            parser.error('the input and spec arguments are required without --perf-log')
+
+        # Load hardware configuration
+        with open(args.cfg, 'r') as f:
+            cfg = json5.load(f)
 
-    # Read and render input files
-    data, spec = load_json_inputs(args.input, args.spec, cfg=cfg)
+        # Read and render input files
+        data, spec = load_json_inputs(args.input, args.spec, cfg=cfg)
 
-    # Process inputs and generate output JSON
-    output = filter_and_label_rois(data, spec)
+        # Process inputs and generate output JSON
+        output = filter_and_label_rois(data, spec)
 
     # Write output to file
     with open(args.output, 'w') as f:
@@ -8,7 +8,8 @@
 import json
 from pathlib import Path
 import pytest
-from bench.roi import get_roi, format_roi, load_json_inputs, filter_and_label_rois
+from bench.roi import get_roi, format_roi, load_json_inputs, filter_and_label_rois, \
+    parse_perf_record
 
 TEST_DATA_DIR = Path(__file__).resolve().parent / 'test_data'
 INPUT_JSON = TEST_DATA_DIR / 'data.json'
@@ -60,3 +61,25 @@ def test_filter_and_label_rois():
     with open(OUTPUT_JSON, 'r') as f:
         output = json.load(f)
     assert filter_and_label_rois(data, spec) == output
+
+
+def test_parse_perf_record():
+    words = [
+        0x66726570,  # magic
+        (1 << 16) | 3,  # version, cluster index
+        (3 << 16) | 2,  # number of metrics, number of regions
+        0x00000000, 0x00030000, 0x00030001,  # cycle, issue_fpu on harts 0 and 1
+        0, 4, 1000, 200, 180,  # region 0
+        5, 1, 50, 0, 0  # region 5
+    ]
+    record = ''.join(f'{word:08x}' for word in words)
+    cluster_idx, regions = parse_perf_record(record)
+    assert cluster_idx == 3
+    assert regions == [
+        {"label": "region_0", "count": 4,
+         "attrs": {"cycle": 1000, "issue_fpu": 200, "issue_fpu_hart1": 180}},
+        {"label": "region_5", "count": 1,
+         "attrs": {"cycle": 50, "issue_fpu": 0, "issue_fpu_hart1": 0}}
+    ]
+    with pytest.raises(ValueError):
+        parse_perf_record(record[:-8])
@@ -36,7 +36,8 @@ def emit_license():
 # Enum value can be a string or an integer, this function uniformizes the result to integers only
 def _integer_precision_t(prec):
     if isinstance(prec, str):
-        return {'FP64': 8, 'FP32': 4, 'FP16': 2, 'FP8': 1}[prec]
+        return {'FP64': 8, 'FP32': 4, 'FP16': 2, 'FP8': 1,
+                'INT32': 0x14, 'INT16': 0x12, 'INT8': 0x11}[prec]
     else:
         return prec
 
@@ -48,7 +49,8 @@ def size_from_precision_t(prec):
         prec: A value of type `precision_t`. Accepts both enum strings
             (e.g. "FP64") and integer enumeration values (e.g. 8).
     """
-    return _integer_precision_t(prec)
+    # The lower four bits hold the size, bit 4 flags integer types
+    return _integer_precision_t(prec) & 0xf
 
 
 def ff_desc_from_precision_t(prec):
@@ -94,7 +96,10 @@ def numpy_type_from_precision_t(prec):
     precision_t_to_numpy_type_map = {
         8: np.float64,
         4: np.float32,
-        2: np.float16
+        2: np.float16,
+        0x14: np.int32,
+        0x12: np.int16,
+        0x11: np.int8
     }
     prec = _integer_precision_t(prec)
     assert prec != 1, "No direct correspondence between FP8 and Numpy"
@@ -113,7 +118,10 @@ def ctype_from_precision_t(prec):
         8: 'double',
         4: 'float',
         2: '__fp16',
-        1: '__fp8'
+        1: '__fp8',
+        0x14: 'int32_t',
+        0x12: 'int16_t',
+        0x11: 'int8_t'
     }
     return precision_t_to_ctype_map[_integer_precision_t(prec)]
 
@@ -273,6 +281,9 @@ def from_buffer(byte_array, ctype='uint32_t'):
     # Types which have a direct correspondence in Numpy
     NP_DTYPE_FROM_CTYPE = {
         'uint32_t': np.uint32,
+        'int32_t': np.int32,
+        'int16_t': np.int16,
+        'int8_t': np.int8,
         'double': np.float64,
         'float': np.float32,
         '__fp16': np.float16